@@ -33,60 +33,128 @@
  */
 
 #include <librt.h>
-size_t gets_feedback( char* buffer, size_t buffer_size )
-{
-  uint ptr = 0;
-  char c;
-  while (( (c = getc()) != '\n') && ptr < (buffer_size) - 1 )
-  {
-    if (c == 127) {
-      if (ptr > 0) {
-        --ptr;
-        puts( "\b \b" );
-      }
-    } else {
-      buffer[ptr++] = c;
-      putc( c );
-    }
-  }
-  buffer[ptr] = '\0';
-  return ptr;
-}
-/*----------------------------------------------------------------------------*/
+
+/*! Sampling interval of the 'prof' command in microseconds. */
+const unsigned int PROFILE_INTERVAL = 1000;
+
+/*! File the 'trace' command appends the records to. */
+static const char* TRACE_LOG = "results.log";
+
+/*! Records taken by the 'trace' command, a full kernel ring and the
+ * TRACE_LOST record. */
+static TRACE_RECORD trace_records[4097];
+
 process_t exec( const char* file_name)
 {
-	file_t fd;
-	if (!fopen( &fd, file_name, OPEN_R ) == EOK) {
+	process_t child_pid;
+	const int res = process_spawn( &child_pid, file_name );
+	if (res == EIO) {
 		printf( "Opening of file %s failed.\n", file_name );
 		return 0;
 	}
-
-	const size_t size = fseek( fd, POS_END, 0 );
-	fseek( fd, POS_START, 0 );
-
-	if (size == 0){
-		printf( "File is empty.\n" );
+	if (res != EOK) {
+		printf( "Process creation failed.\n" );
 		return 0;
 	}
-
-	void* image = malloc(size);
-	if (!image) {
-		printf( "Space allocation failed!\n" );
-		return false;
+	return child_pid;
+}
+/*----------------------------------------------------------------------------*/
+/*! Converts cycles to milliseconds, there is no 64-bit division. */
+uint cycles_to_ms( uint64_t cycles, uint cycles_per_usec )
+{
+	/* units of 1024 usecs, 1024/1000 == 1 + 3/125 */
+	const uint units = (uint)(cycles >> 10) / (cycles_per_usec ? cycles_per_usec : 1);
+	return units + units * 3 / 125;
+}
+/*----------------------------------------------------------------------------*/
+/*! Lists running processes and their resource usage. */
+void top()
+{
+	printf( "PID\tTHREADS\tCPU(ms)\tSYSCALLS\tTLB\tVMAS\tMEM(KB)"
+		"\tSHR(KB)\tREAD(KB)\tWRITTEN(KB)\n" );
+	PROCESS_STAT st;
+	for (process_t pid = 0; process_stat( pid, &st ) == EOK; pid = st.pid + 1) {
+		printf( "%u\t%u\t%u\t%u\t\t%u\t%u\t%u\t%u\t%u\t\t%u\n",
+			st.pid, st.threads, cycles_to_ms( st.cpu_cycles, st.cycles_per_usec ),
+			st.syscalls, st.tlb_refills, st.areas,
+			st.resident / 1024, st.shared / 1024, (uint)(st.read_bytes >> 10),
+			(uint)(st.written_bytes >> 10) );
+	}
+}
+/*----------------------------------------------------------------------------*/
+/*! Runs the program under the profiler and prints the histogram. */
+void profile( const char* file_name )
+{
+	/* program.bin is described by program.map */
+	char map[50];
+	size_t len = 0;
+	while (file_name[len] && len < sizeof(map) - 1) {
+		map[len] = file_name[len];
+		++len;
+	}
+	map[len] = '\0';
+	if (len > 4 && map[len - 4] == '.') {
+		map[len - 3] = 'm'; map[len - 2] = 'a'; map[len - 1] = 'p';
 	}
 
-	int res;
-	if ( (res = fread( fd, image, size )) < 0) {
-		printf( "File reading failed. %d \n", res);
-		free(image);
-		return 0;
+	if (profile_start( PROFILE_INTERVAL ) != EOK) {
+		printf( "Failed to start the profiler.\n" );
+		return;
 	}
-	process_t child_pid;
-	if (process_create( &child_pid, image, size ) != EOK) {
-		printf( "Process creation failed.\n" );
-		return 0;
+	const process_t pid = exec( file_name );
+	if (pid)
+		process_join( pid );
+	profile_stop();
+	if (pid)
+		profile_dump( map );
+}
+/*----------------------------------------------------------------------------*/
+/*! Runs the program with tracing enabled and appends the trace to the log,
+ * tools/tracedump decodes it. */
+void trace( const char* args )
+{
+	uint mask = 0;
+	for (; *args && *args != ' '; ++args) {
+		const char c = *args;
+		const uint digit = (c >= '0' && c <= '9') ? c - '0'
+			: (c >= 'a' && c <= 'f') ? c - 'a' + 10 : 16;
+		if (digit == 16) {
+			printf( "Mask has to be hexadecimal.\n" );
+			return;
+		}
+		mask = mask * 16 + digit;
 	}
-	return child_pid;
+	while (*args == ' ')
+		++args;
+
+	trace_read( trace_records, sizeof(trace_records) / sizeof(TRACE_RECORD) );
+	trace_enable( mask );
+	const process_t pid = exec( args );
+	if (pid)
+		process_join( pid );
+	trace_enable( 0 );
+
+	const int count =
+		trace_read( trace_records, sizeof(trace_records) / sizeof(TRACE_RECORD) );
+	file_t fd;
+	if (count < 0 || fopen( &fd, TRACE_LOG, OPEN_A ) != EOK) {
+		printf( "Failed to store the trace.\n" );
+		return;
+	}
+	fwrite( fd, TRACE_DUMP_MAGIC, sizeof(TRACE_DUMP_MAGIC) - 1 );
+	fwrite( fd, &count, sizeof(count) );
+	fwrite( fd, trace_records, count * sizeof(TRACE_RECORD) );
+	fclose( fd );
+	printf( "%d trace records appended to %s.\n", count, TRACE_LOG );
+}
+/*----------------------------------------------------------------------------*/
+/*! Checks whether the command line starts with the word. */
+bool starts_with( const char* line, const char* word )
+{
+	while (*word)
+		if (*line++ != *word++)
+			return false;
+	return true;
 }
 /*----------------------------------------------------------------------------*/
 int main ()
@@ -101,7 +169,9 @@ int main ()
 	const size_t BUFF_SIZE = 50;
 	char buffer[BUFF_SIZE];
 	while (true) {
-		printf( "Select one of the files to run or type \'q\' to exit:\n" );
+		printf( "Select one of the files to run, type \'top\' to list processes, "
+			"\'prof <file>\' to profile a run, \'trace <hex mask> <file>\' "
+			"to trace a run or \'q\' to exit:\n" );
 		DIR_ENTRY file;
 		fseek( curr_dir, POS_START, 0 );
 		while (direntry( curr_dir, &file) == EOK){
@@ -109,10 +179,21 @@ int main ()
 				printf( " %s\n", file.name );
 		}
 		puts("\n$ ");
-		gets_feedback( buffer, BUFF_SIZE );
-		printf( "\n" );
+		gets( buffer, BUFF_SIZE );
 		if (buffer[0] == 'q' && buffer[1] == '\0')
 			break;
+		if (starts_with( buffer, "top" ) && buffer[3] == '\0') {
+			top();
+			continue;
+		}
+		if (starts_with( buffer, "prof " )) {
+			profile( buffer + 5 );
+			continue;
+		}
+		if (starts_with( buffer, "trace " )) {
+			trace( buffer + 6 );
+			continue;
+		}
 		process_t pid = exec(buffer);
 		process_join( pid );
 	}
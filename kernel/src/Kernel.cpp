@@ -31,14 +31,20 @@
  */
 #include "Kernel.h"
 #include "proc/KernelThread.h"
+#include "proc/Process.h"
 #include "api.h"
 #include "devices.h"
 #include "tools.h"
 #include "InterruptDisabler.h"
 #include "timer/Timer.h"
+#include "timer/Profiler.h"
+#include "Tracer.h"
 #include "mem/FrameAllocator.h"
 #include "mem/TLB.h"
 #include "drivers/MsimDisk.h"
+#include "drivers/StripedDisk.h"
+#include "drivers/BlockCache.h"
+#include "drivers/RamDisk.h"
 
 //#define KERNEL_DEBUG
 
@@ -69,7 +75,8 @@ extern void* volatile* other_stack_ptr;
 Kernel::Kernel() :
 	Thread( 0 ),   /* We need no stack. (We use static stack one :) ) */
 	m_console( CHARACTER_OUTPUT_ADDRESS, CHARACTER_INPUT_ADDRESS ),
-	m_clock( CLOCK )
+	m_clock( CLOCK ),
+	m_rawDisk( NULL )
 {
 	registerInterruptHandler( &m_console, CHARACTER_INPUT_INTERRUPT );
 	registerInterruptHandler( &Timer::instance(), TIMER_INTERRUPT );
@@ -77,6 +84,7 @@ Kernel::Kernel() :
 	registerExceptionHandler( &m_syscalls, Processor::CAUSE_EXCCODE_SYS );
 	registerExceptionHandler( this, Processor::CAUSE_EXCCODE_INT  );
 	registerExceptionHandler( this, Processor::CAUSE_EXCCODE_BP   );
+	registerExceptionHandler( &TLB::instance(), Processor::CAUSE_EXCCODE_MOD );
 
 	m_status = INITIALIZED;
 }
@@ -164,6 +172,9 @@ void Kernel::run()
 		attachDisks();
 	}
 	{
+		// console output is buffered from now on
+		m_console.startDrainer();
+
 		//init and run the main thread
 		thread_t mainThread;
 		Thread* main = KernelThread::create(&mainThread, first_thread, NULL, TF_NEW_VMM);
@@ -227,6 +238,37 @@ void Kernel::exception( Processor::Context* registers )
 	
 	if (Thread::shouldSwitch())
 		Thread::getCurrent()->yield();
+
+	/* keep the exported clock at most one quantum old */
+	if (reason == Processor::CAUSE_EXCCODE_INT
+	    && (registers->cause & Processor::INTERRUPT_MASKS[TIMER_INTERRUPT])
+	    && Thread::getCurrent()) {
+		Process* process = Thread::getCurrent()->process();
+		if (process)
+			process->updateClock();
+	}
+}
+/*----------------------------------------------------------------------------*/
+unative_t Kernel::syscall( unative_t params[], uint number )
+{
+	InterruptDisabler inter;
+
+	Process* caller = Process::getCurrent();
+	if (caller)
+		caller->countSyscall();
+	TRACE( SYSCALL_ENTER, number, 0 );
+
+	unative_t result = 0;
+	if (!m_syscalls.handleSyscall( number, params, result )) {
+		printf( "Syscall %u UNHANDLED => KILLING offending thread (%u).\n",
+			number, Thread::getCurrent()->id() );
+		Thread::getCurrent()->kill();
+	}
+	TRACE( SYSCALL_EXIT, number, result );
+
+	if (Thread::shouldSwitch())
+		Thread::getCurrent()->yield();
+	return result;
 }
 /*----------------------------------------------------------------------------*/
 bool Kernel::handleException( Processor::Context* registers )
@@ -267,6 +309,10 @@ void Kernel::handleInterrupts( Processor::Context* registers )
 	using namespace Processor;
 	InterruptDisabler inter;
 
+	TRACE( INTERRUPT, registers->cause, registers->epc );
+	if (registers->cause & INTERRUPT_MASKS[TIMER_INTERRUPT])
+		PROFILER.sample( registers );
+
 	for (uint i = 0; i < INTERRUPT_COUNT; ++i)
 		if (registers->cause & INTERRUPT_MASKS[i]) {
 			ASSERT (m_interruptHandlers[i]);
@@ -281,12 +327,18 @@ void Kernel::setTimeInterrupt(const Time& time)
 	const Time now      = Time::getCurrent();
 	const Time relative = ( time > now ) ? time - now : Time( 0, 0 );
 
-	unative_t current   = Processor::reg_read_count();
+	const unative_t count = Processor::reg_read_count();
+	unative_t current   = count;
 	const uint usec     = relative.toUsecs();
 
  	if (time) {
 		current = roundUp(current + (usec * m_timeToTicks), m_timeToTicks * 10 * RTC::MILLI_SECOND); // 10 ms time slot
 	}
+
+	/* the profiler samples on timer interrupts, do not let it wait longer */
+	const unative_t sampling = PROFILER.interval();
+	if (sampling && (!time || current - count > sampling))
+		current = count + sampling;
 	
 	PRINT_DEBUG
 		("[%u:%u] Set time interrupt in %u usecs current: %x, planned: %x.\n",
@@ -299,6 +351,10 @@ void Kernel::refillTLB()
 {
   InterruptDisabler inter;
 
+	Process* process = Process::getCurrent();
+	if (process)
+		process->countTlbRefill();
+
   bool success = TLB::instance().refill(
 		IVirtualMemoryMap::getCurrent(), Processor::reg_read_badvaddr() );
 	
@@ -319,14 +375,55 @@ void Kernel::refillTLB()
 /*----------------------------------------------------------------------------*/
 void Kernel::attachDisks()
 {
-	DiskDevice* disk = new MsimDisk( HDD0_ADDRESS );
-	registerInterruptHandler( disk, HDD0_INTERRUPT );
-	ASSERT (disk);
-	m_disks.pushBack( disk );
+	static unative_t* const addresses[] =
+		{ HDD0_ADDRESS, HDD1_ADDRESS, HDD2_ADDRESS, HDD3_ADDRESS };
+	static const uint interrupts[] =
+		{ HDD0_INTERRUPT, HDD1_INTERRUPT, HDD2_INTERRUPT, HDD3_INTERRUPT };
+	const uint count = min<uint>( DISK_COUNT, StripedDisk::MAX_DISKS );
+
+	DiskDevice* disks[StripedDisk::MAX_DISKS];
+	for (uint i = 0; i < count; ++i) {
+		disks[i] = new MsimDisk( addresses[i] );
+		ASSERT (disks[i]);
+		registerInterruptHandler( disks[i], interrupts[i] );
+	}
+
+	/* several disks form one striped volume */
+	DiskDevice* disk = disks[0];
+	if (count > 1) {
+		disk = new StripedDisk( disks, count );
+		ASSERT (disk);
+		printf( "Striping volume over %u disks.\n", count );
+	}
+	m_rawDisk = disk;
+
+	/* file systems read through the cache */
+	DiskDevice* cache = new BlockCache(
+		disk, m_physicalMemorySize / BlockCache::RAM_FRACTION );
+	ASSERT (cache);
+	m_disks.pushBack( cache );
+
+#ifdef RAMDISK
+	/* preloaded image becomes the first (root) disk, no disk I/O */
+	if (RamDisk::hasImage( RAMDISK_ADDRESS )) {
+		RamDisk* ram = new RamDisk( RAMDISK_ADDRESS, RAMDISK_SIZE );
+		ASSERT (ram);
+		m_disks.pushFront( ram );
+		printf( "Using RAM disk at %p (%u KB).\n",
+			RAMDISK_ADDRESS, RAMDISK_SIZE / 1024 );
+	} else {
+		printf( "RAM disk image not found, using the disk.\n" );
+	}
+#endif
 }
 /*----------------------------------------------------------------------------*/
 Time Time::getCurrentTime()
 {
 	return Time( KERNEL.clock().time(), KERNEL.clock().usec() );
 }
+/*----------------------------------------------------------------------------*/
+Time Time::getCoarseTime()
+{
+	return getCurrentTime();
+}
 
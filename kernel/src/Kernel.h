@@ -98,7 +98,7 @@ public:
 	static inline void stop() { Processor::msim_stop(); };
 	
 	/*! @brief Stops execution, shuts down msim. */
-	static inline void halt() { Processor::msim_halt(); };
+	inline void halt() { m_console.flush(); Processor::msim_halt(); };
 
 	/*! @brief Dumps registers of the active processor. */
 	static inline void regDump() { Processor::msim_reg_dump(); };
@@ -114,6 +114,15 @@ public:
 	 */
 	void exception( Processor::Context* registers );
 
+	/*!
+	 * @brief Syscall handling member function, called by the lean
+	 * syscall entry that does not store the whole context.
+	 * @param params Syscall parameters (registers a0-a3).
+	 * @param number Syscall code (register v0).
+	 * @return Return value of the syscall.
+	 */
+	unative_t syscall( unative_t params[], uint number );
+
 	/*! 
 	 * @brief Handler for exceptions that are handled directly by the kernel.
 	 */
@@ -123,6 +132,8 @@ public:
 		ExceptionHandler* handler, Processor::Exceptions exception );
 
 	/*! @brief Sets interrupt on given time or sooner.
+	 *
+	 * The running profiler gets the interrupt every sampling interval.
 	 * @param time Desired time of interrupt
 	 */
 	void setTimeInterrupt( const Time& time );
@@ -138,14 +149,24 @@ public:
 	/*! @brief Gets the first disk. */
 	inline DiskDevice* disk() { return m_disks.getFront(); };
 
+	/*! @brief Gets the disk (or the striped volume) under the block cache. */
+	inline DiskDevice* rawDisk() { return m_rawDisk; };
+
 	inline TarFS* rootFS() { return m_rootFS; };
 
+	/*! @brief Gets the syscall handling vector. */
+	inline SyscallHandler& syscalls() { return m_syscalls; };
+
+	/*! @brief Gets the frequency of the CP0 Count register in MHz. */
+	inline uint cyclesPerUsec() const { return m_timeToTicks; };
+
 private:
 	Console m_console;                 /*!< Console device.        */
 	const RTC m_clock;                 /*!< Clock device.          */
 	size_t m_physicalMemorySize;       /*!< Detected memory size.  */	
 	uint m_timeToTicks;                /*!< Converting constant.   */
 	DiskList m_disks;									 /*!< Disks.                 */
+	DiskDevice* m_rawDisk;             /*!< Disk under the cache.  */
 	TarFS* m_rootFS;                   /*!< /.                     */
 	SyscallHandler m_syscalls;         /*!< Handles Syscalls.      */
 	void printBunnies( uint count );   /*!< @brief Prints BUNNIES. */
@@ -68,19 +68,34 @@ SyscallHandler::SyscallHandler()
 	m_handles[SYS_PROC_CREATE] = handleProcessCreate;
 	m_handles[SYS_PROC_JOIN]   = handleProcessJoin;
 	m_handles[SYS_PROC_KILL]   = handleProcessKill;
+	m_handles[SYS_PROC_SPAWN]  = handleProcessSpawn;
 
 	m_handles[SYS_GET_TIME] = handleGetTime;
+	m_handles[SYS_NOP]      = handleNop;
+	m_handles[SYS_SUBMIT]   = handleSubmit;
+
+	m_handles[SYS_STAT_PROCESS] = handleStatProcess;
+	m_handles[SYS_STAT_THREAD]  = handleStatThread;
+	m_handles[SYS_PROFILE]      = handleProfile;
+	m_handles[SYS_TRACE]        = handleTrace;
 
 	m_handles[SYS_FS_OPEN]  = handleFsOpen;
 	m_handles[SYS_FS_CLOSE] = handleFsClose;
 	m_handles[SYS_FS_READ]  = handleFsRead;
 	m_handles[SYS_FS_SEEK]  = handleFsSeek;
 	m_handles[SYS_FS_ENTRY] = handleFsDirEntry;
+	m_handles[SYS_FS_MMAP]  = handleFsMmap;
+	m_handles[SYS_FS_READ_ASYNC] = handleFsReadAsync;
+	m_handles[SYS_FS_PREAD] = handleFsPread;
+	m_handles[SYS_FS_READV] = handleFsReadv;
+	m_handles[SYS_FS_WRITE] = handleFsWrite;
+	m_handles[SYS_FS_SYNC]  = handleFsSync;
 }
 /*----------------------------------------------------------------------------*/
 bool SyscallHandler::handleException( Processor::Context* registers )
 {
-	uint syscall = ((*(unative_t*)registers->epc)>>6);
+	/* syscall code is passed in v0, the same as for the lean entry */
+	const uint syscall = registers->v0;
 
 	unative_t params[4];
 
@@ -93,10 +108,63 @@ bool SyscallHandler::handleException( Processor::Context* registers )
 		m_call, m_params[0], m_params[1], m_params[2], m_params[3]);
 // */
 
-	if (!m_handles[syscall]) return false;
+	if (!handleSyscall( syscall, params, registers->v0 )) return false;
 
-	registers->v0   = this->m_handles[syscall]( params );
 	registers->epc += 4;
 	
 	return true;
 }
+/*----------------------------------------------------------------------------*/
+unative_t SyscallHandler::submit( SUBMIT_RING* ring )
+{
+	ASSERT (ring);
+	uint count = 0;
+
+	while (ring->sq_head != ring->sq_tail) {
+		const uint head = ring->sq_head;
+		if (ring->sq_tail - head > SUBMIT_RING_SIZE)
+			return EINVAL;
+
+		/* no space for the result */
+		const uint tail = ring->cq_tail;
+		if (tail - ring->cq_head >= SUBMIT_RING_SIZE)
+			break;
+
+		/* take the entry and reserve its completion before running it,
+		 * it might block and other threads may submit meanwhile */
+		const SUBMIT_ENTRY& entry = ring->sq[head % SUBMIT_RING_SIZE];
+		const uint code = entry.code;
+		const unative_t tag = entry.tag;
+		unative_t params[4] =
+			{ entry.params[0], entry.params[1], entry.params[2], entry.params[3] };
+		ring->sq_head = head + 1;
+
+		COMPLETION_ENTRY& completion = ring->cq[tail % SUBMIT_RING_SIZE];
+		completion.ready = 0;
+		ring->cq_tail = tail + 1;
+
+		/* exits would leave the ring of a dead thread or process behind */
+		unative_t result = EINVAL;
+		if (code != SYS_SUBMIT && code != SYS_EXIT && code != SYS_THREAD_EXIT) {
+			/* batched syscalls are accounted and traced one by one */
+			Process* caller = Process::getCurrent();
+			if (caller)
+				caller->countSyscall();
+			TRACE( SYSCALL_ENTER, code, 0 );
+			if (!handleSyscall( code, params, result ))
+				result = EINVAL;
+			TRACE( SYSCALL_EXIT, code, result );
+		}
+
+		/* the syscall might have killed the caller (kill of its own process,
+		 * bad pointer), the ring might be freed already */
+		if (Thread::getCurrent()->status() != Thread::RUNNING)
+			return EKILLED;
+
+		completion.tag    = tag;
+		completion.result = result;
+		completion.ready  = 1;
+		++count;
+	}
+	return count;
+}
@@ -34,6 +34,7 @@
 #include "drivers/Processor.h"
 #include "ExceptionHandler.h"
 #include "syscallcodes.h"
+#include "submit.h"
 
 /*!
  * @class SyscallHandler SyscallHandler.h "SyscallHandler.h"
@@ -59,6 +60,36 @@ public:
 	 */
 	bool handleException( Processor::Context* registers );
 
+	/*!
+	 * @brief Calls handling routine of the syscall.
+	 * @param syscall Syscall code.
+	 * @param params Syscall parameters.
+	 * @param result Place to store the return value of the routine.
+	 * @return @a true if handler to the syscall was found and called,
+	 * 	@a false otherwise.
+	 */
+	inline bool handleSyscall( uint syscall, unative_t params[], unative_t& result )
+	{
+		if (syscall >= SYS_COUNT || !m_handles[syscall]) return false;
+		result = m_handles[syscall]( params );
+		return true;
+	}
+
+	/*!
+	 * @brief Runs syscalls waiting in the submission ring.
+	 *
+	 * Every taken submission gets its completion slot reserved first, so
+	 * syscalls that block do not stop other threads submitting to the
+	 * same ring. Stops when the ring is empty or there is no space for
+	 * the results. SYS_SUBMIT, SYS_EXIT and SYS_THREAD_EXIT are refused
+	 * with EINVAL, the ring is not touched after a syscall killed the
+	 * caller.
+	 * @param ring Submission ring of the current process.
+	 * @return Number of the syscalls run, EINVAL if the ring is corrupted,
+	 * 	EKILLED if the caller was killed.
+	 */
+	unative_t submit( SUBMIT_RING* ring );
+
 private:
 	/*! @brief Syscall handling vector. */
 	unative_t (*m_handles[SYS_COUNT])(unative_t par[]);
@@ -0,0 +1,87 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*!
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Tracer class implementation.
+ */
+
+#include "Tracer.h"
+#include "Kernel.h"
+#include "InterruptDisabler.h"
+#include "proc/Thread.h"
+
+/*----------------------------------------------------------------------------*/
+uint Tracer::enable( uint mask )
+{
+	InterruptDisabler interrupts;
+
+	const uint old_mask = m_mask;
+	m_mask = mask & TRACE_ALL;
+	if (m_mask)
+		record( TRACE_START, KERNEL.cyclesPerUsec(), m_mask );
+	return old_mask;
+}
+/*----------------------------------------------------------------------------*/
+void Tracer::record( uint event, unative_t arg0, unative_t arg1 )
+{
+	InterruptDisabler interrupts;
+
+	TRACE_RECORD& record = m_ring[m_head++ % RING_SIZE];
+	record.cycles = Processor::reg_read_count();
+	record.event  = event;
+	record.thread = Thread::getCurrent() ? Thread::getCurrent()->id() : 0;
+	record.arg0   = arg0;
+	record.arg1   = arg1;
+}
+/*----------------------------------------------------------------------------*/
+uint Tracer::read( TRACE_RECORD* buffer, uint count )
+{
+	uint done = 0;
+	while (done < count) {
+		TRACE_RECORD record;
+		{
+			InterruptDisabler interrupts;
+			if (m_tail == m_head)
+				break;
+
+			const uint lost = (m_head - m_tail > RING_SIZE)
+				? m_head - m_tail - RING_SIZE : 0;
+			if (lost) {
+				m_tail += lost;
+				record.cycles = Processor::reg_read_count();
+				record.event  = TRACE_LOST;
+				record.thread = 0;
+				record.arg0   = lost;
+				record.arg1   = 0;
+			} else {
+				record = m_ring[m_tail++ % RING_SIZE];
+			}
+		}
+		/* the buffer may be paged in, do not hold interrupts */
+		buffer[done++] = record;
+	}
+	return done;
+}
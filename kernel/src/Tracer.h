@@ -0,0 +1,111 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *   
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Tracer class declaration and the TRACE macro.
+ *
+ * Binary tracepoints, much cheaper than the *_DEBUG prints.
+ */
+#pragma once
+
+#include "api.h"
+#include "trace.h"
+#include "Singleton.h"
+
+/*!
+ * @brief Records tracepoint @a id if its category is enabled.
+ *
+ * Usage: TRACE( SWITCH, from, to ); see TRACE_EVENTS in trace.h.
+ * A disabled tracepoint costs one load and one branch.
+ */
+#define TRACE( id, arg0, arg1 ) \
+	do { \
+		if (TRACER.enabled( TRACE_CATEGORY_##id )) \
+			TRACER.record( TRACE_##id, (arg0), (arg1) ); \
+	} while (0)
+
+/*!
+ * @class Tracer Tracer.h "Tracer.h"
+ * @brief Ring of binary trace records.
+ *
+ * Records carry the CP0 Count timestamp, the running thread and two
+ * arguments. There is one CPU and so one ring, the oldest records are
+ * overwritten when it is full and the reader is told how many were lost.
+ */
+class Tracer: public Singleton<Tracer>
+{
+public:
+	/*! @brief Number of records in the ring. */
+	static const uint RING_SIZE = 4096;
+
+	/*!
+	 * @brief Checks whether the category is traced.
+	 * @param category TraceCategory.
+	 * @return @a True if records of the category are taken.
+	 */
+	inline bool enabled( uint category ) const
+		{ return (m_mask & category) || category == TRACE_ALWAYS; };
+
+	/*!
+	 * @brief Sets the traced categories.
+	 * @param mask Mask of TraceCategory values, 0 stops tracing.
+	 * @return Previous mask.
+	 *
+	 * Enabling tracing records TRACE_START with the Count frequency.
+	 */
+	uint enable( uint mask );
+
+	/*!
+	 * @brief Stores record to the ring.
+	 * @param event TraceEvent.
+	 * @param arg0 The first argument.
+	 * @param arg1 The second argument.
+	 */
+	void record( uint event, unative_t arg0, unative_t arg1 );
+
+	/*!
+	 * @brief Takes the oldest records.
+	 * @param buffer Place to store the records, may be in the user space.
+	 * @param count Size of the buffer in records.
+	 * @return Number of stored records.
+	 *
+	 * If records were overwritten TRACE_LOST record is stored first.
+	 */
+	uint read( TRACE_RECORD* buffer, uint count );
+
+private:
+	TRACE_RECORD m_ring[RING_SIZE];  /*!< The records.                  */
+	uint m_head;                     /*!< Number of records written.    */
+	uint m_tail;                     /*!< Number of records taken.      */
+	volatile uint m_mask;            /*!< Enabled categories.           */
+
+	/*! @brief Creates empty ring, nothing is traced. */
+	Tracer(): m_head( 0 ), m_tail( 0 ), m_mask( 0 ) {};
+
+	friend class Singleton<Tracer>;
+};
+
+#define TRACER Tracer::instance()
@@ -74,10 +74,7 @@ char getc()
 /*----------------------------------------------------------------------------*/
 int getc_try()
 {
-	if (KERNEL.console().count())
-		return KERNEL.console().getChar();
-	else
-		return EWOULDBLOCK;
+	return KERNEL.console().tryReadChar();
 }
 /*----------------------------------------------------------------------------*/
 ssize_t gets(char* str, const size_t len)
@@ -116,6 +113,8 @@ void kpanic(void** context, const char* format, ...){
 		vprintf(format, args);
 		va_end(args);
 	}
+	/* the drainer will not run again */
+	KERNEL.console().flush();
 
 	KERNEL.stop();
 	KERNEL.block();
@@ -218,6 +217,30 @@ void* memcpy( void* dest, const void* src, size_t count )
 	char* dstc = (char*) dest;
 	char* srcc = (char*) src;
 
+	/* equally aligned buffers are copied by words */
+	if ((((uintptr_t)dstc ^ (uintptr_t)srcc) & (sizeof(uint32_t) - 1)) == 0) {
+		while (((uintptr_t)dstc & (sizeof(uint32_t) - 1)) && count) {
+			*dstc++ = *srcc++;
+			--count;
+		}
+
+		uint32_t* dstw = (uint32_t*) dstc;
+		const uint32_t* srcw = (const uint32_t*) srcc;
+		for (; count >= 4 * sizeof(uint32_t); count -= 4 * sizeof(uint32_t)) {
+			dstw[0] = srcw[0];
+			dstw[1] = srcw[1];
+			dstw[2] = srcw[2];
+			dstw[3] = srcw[3];
+			dstw += 4;
+			srcw += 4;
+		}
+		for (; count >= sizeof(uint32_t); count -= sizeof(uint32_t))
+			*dstw++ = *srcw++;
+
+		dstc = (char*) dstw;
+		srcc = (char*) srcw;
+	}
+
 	while (count--) {
 			*dstc++ = *srcc++;
 	}
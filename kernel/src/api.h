@@ -90,7 +90,8 @@ size_t printf( const char * format, ... );
 
 /*! @brief Reads one char from the device buffer.
  * @return Read char.
- * If there is no char in the input buffer requesting thread is blocked.
+ * Only chars of finished lines can be read, input is echoed and edited
+ * by the console. If there is no such char requesting thread is blocked.
  */
 char getc();
 
@@ -103,8 +104,9 @@ int getc_try();
 
 /*! @brief Tries to read multiple chars from the device buffer.
  *
- * If len is 0 returns EINVAL. Reads from the buffer until '\n'
- * is read or len characters were read. \\0 is always put at the end.
+ * If len is 0 returns EINVAL. Waits for a finished line and reads it
+ * until '\n' is read or len characters were read. \\0 is always put
+ * at the end instead of '\n'.
  * @param str pointer to the buffer to be filled.
  * @param len number of chars to be read if no \\n is encountered.
  * @retval number of chars filled into buffer str.
@@ -51,6 +51,23 @@
 #define HDD0_ADDRESS    (unative_t*)(0xffffffc0)
 #define HDD0_INTERRUPT    2
 
+/*! additional hdds, striped with hdd0 (see msim-raid*.conf) */
+#define HDD1_ADDRESS    (unative_t*)(0xffffffa0)
+#define HDD1_INTERRUPT    4
+#define HDD2_ADDRESS    (unative_t*)(0xffffff90)
+#define HDD2_INTERRUPT    5
+#define HDD3_ADDRESS    (unative_t*)(0xffffff80)
+#define HDD3_INTERRUPT    6
+
+/*! number of attached hdds, set by make DISKS=n */
+#ifndef DISK_COUNT
+#define DISK_COUNT 1
+#endif
+
+/*! ram disk, memory preloaded with the disk image (see msim-ramdisk.conf) */
+#define RAMDISK_ADDRESS 0x1c000000
+#define RAMDISK_SIZE    (16 * 1024 * 1024)
+
 /*! dorder */
 #define DORDER_ADDRESS (unative_t*)(0xFFFFFFB0)
 #define DORDER_INTERRUPT 3
@@ -0,0 +1,525 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief BlockCache class implementation.
+ */
+
+#include "BlockCache.h"
+#include "api.h"
+#include "address.h"
+#include "tools.h"
+#include "InterruptDisabler.h"
+#include "mem/Memory.h"
+#include "mem/FrameAllocator.h"
+#include "proc/KernelThread.h"
+
+//#define BLOCK_CACHE_DEBUG
+
+#ifndef BLOCK_CACHE_DEBUG
+#define PRINT_DEBUG(...)
+#else
+#define PRINT_DEBUG(ARGS...) \
+  printf("[ BLOCK CACHE DEBUG ]: "); \
+  printf(ARGS);
+#endif
+
+using namespace Processor;
+
+uint BlockCache::reclaim( uint count )
+{
+	InterruptDisabler inter;
+
+	uint freed = 0;
+	for (List<BlockCache*>::Iterator it = caches().begin();
+		it != caches().end() && freed < count; ++it) {
+		freed += (*it)->drop( count - freed );
+	}
+	PRINT_DEBUG ("Reclaimed %u frames.\n", freed);
+	return freed;
+}
+/*----------------------------------------------------------------------------*/
+BlockCache::BlockCache( DiskDevice* device, size_t capacity ):
+	m_device( device ), m_capacity( capacity / Memory::frameSize( PAGE_MIN ) ),
+	m_lineCount( 0 ), m_hits( 0 ), m_misses( 0 ), m_prefetched( 0 ),
+	m_dirtyBlocks( 0 ), m_worker( NULL ), m_pending( 0 ), m_queueStart( 0 ),
+	m_queueCount( 0 ), m_flusher( NULL ), m_flushRequest( 0 )
+{
+	ASSERT (m_device);
+	ASSERT (BLOCKS_PER_LINE * BLOCK_SIZE == Memory::frameSize( PAGE_MIN ));
+
+	for (uint i = 0; i < BUCKET_COUNT; ++i)
+		m_buckets[i] = NULL;
+
+	PRINT_DEBUG ("Created cache of %u lines for device %p.\n",
+		m_capacity, m_device);
+
+	InterruptDisabler inter;
+	append( &caches() );
+}
+/*----------------------------------------------------------------------------*/
+bool BlockCache::read( void* buffer, uint count, uint block, uint start_pos )
+{
+	char* target = (char*)buffer;
+	block    += start_pos / BLOCK_SIZE;
+	start_pos = start_pos % BLOCK_SIZE;
+
+	while (count) {
+		/* large transfers go straight to the destination */
+		const uint run = (start_pos || count < BYPASS_BLOCKS * BLOCK_SIZE)
+			? 0 : uncached( block, count / BLOCK_SIZE );
+		if (run >= BYPASS_BLOCKS) {
+			PRINT_DEBUG ("Bypassing cache for %u blocks from %u.\n", run, block);
+			m_misses += run;
+			if (!m_device->read( target, run * BLOCK_SIZE, block, 0 ))
+				return false;
+			target += run * BLOCK_SIZE;
+			count  -= run * BLOCK_SIZE;
+			block  += run;
+			continue;
+		}
+
+		const uint part = min( count, BLOCK_SIZE - start_pos );
+		if (!readBlock( target, block, start_pos, part ))
+			return false;
+		target += part;
+		count  -= part;
+		start_pos = 0;
+		++block;
+	}
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+bool BlockCache::readBlock( char* buffer, uint block, uint start_pos, uint count )
+{
+	InterruptDisabler inter;
+
+	const uint32_t mask = 1 << (block % BLOCKS_PER_LINE);
+	Line* line = find( block );
+
+	if (line && (line->valid & mask)) {
+		++m_hits;
+	} else {
+		++m_misses;
+		if (!line && !(line = getLine( block ))) {
+			/* nothing to cache the block in, read it directly */
+			PRINT_DEBUG ("No line for block %u.\n", block);
+			return m_device->read( buffer, count, block, start_pos );
+		}
+
+		if (!fetch( line, block ))
+			return false;
+	}
+
+	line->prepend( &m_lru );
+
+	/* copying to the user memory might need frames, keep the line */
+	++line->busy;
+	memcpy( buffer, line->data + (block % BLOCKS_PER_LINE) * BLOCK_SIZE
+		+ start_pos, count );
+	--line->busy;
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+uint BlockCache::uncached( uint block, uint limit )
+{
+	InterruptDisabler inter;
+
+	uint count = 0;
+	while (count < limit) {
+		const Line* line = find( block + count );
+		if (line && (line->valid & (1 << ((block + count) % BLOCKS_PER_LINE))))
+			break;
+		++count;
+	}
+	return count;
+}
+/*----------------------------------------------------------------------------*/
+bool BlockCache::fetch( Line* line, uint block )
+{
+	const uint32_t mask = 1 << (block % BLOCKS_PER_LINE);
+
+	/* line must not be reused while the disk writes to it */
+	++line->busy;
+	/* someone else is reading the block, it might get dirty meanwhile */
+	while (line->loading & mask)
+		Thread::getCurrent()->yield();
+
+	bool success = true;
+	if (!(line->valid & mask)) {
+		line->loading |= mask;
+		success = m_device->read( line->data
+			+ (block % BLOCKS_PER_LINE) * BLOCK_SIZE, BLOCK_SIZE, block, 0 );
+		line->loading &= ~mask;
+		if (success)
+			line->valid |= mask;
+	}
+	--line->busy;
+	return success;
+}
+/*----------------------------------------------------------------------------*/
+bool BlockCache::fill( uint block )
+{
+	InterruptDisabler inter;
+
+	Line* line = find( block );
+	if (line && (line->valid & (1 << (block % BLOCKS_PER_LINE))))
+		return true;
+
+	if (!line && !(line = getLine( block )))
+		return false;
+
+	if (!fetch( line, block ))
+		return false;
+
+	++m_prefetched;
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+void BlockCache::prefetch( uint block, uint count )
+{
+	InterruptDisabler inter;
+
+	if (!m_worker) {
+		thread_t id;
+		m_worker = KernelThread::create( &id, prefetchThread, this, TF_NEW_VMM );
+		if (!m_worker) return;
+		PRINT_DEBUG ("Started prefetch thread %u.\n", id);
+	}
+
+	if (m_queueCount == QUEUE_SIZE) {
+		PRINT_DEBUG ("Prefetch queue full, dropping %u+%u.\n", block, count);
+		return;
+	}
+
+	Request& request = m_queue[(m_queueStart + m_queueCount++) % QUEUE_SIZE];
+	request.block = block;
+	request.count = count;
+	m_pending.up();
+}
+/*----------------------------------------------------------------------------*/
+void* BlockCache::prefetchThread( void* cache )
+{
+	((BlockCache*)cache)->prefetchLoop();
+	return NULL;
+}
+/*----------------------------------------------------------------------------*/
+void BlockCache::prefetchLoop()
+{
+	while (true) {
+		m_pending.down();
+
+		Request request;
+		{
+			InterruptDisabler inter;
+			ASSERT (m_queueCount);
+			request = m_queue[m_queueStart];
+			m_queueStart = (m_queueStart + 1) % QUEUE_SIZE;
+			--m_queueCount;
+		}
+
+		PRINT_DEBUG ("Prefetching %u blocks from %u.\n",
+			request.count, request.block);
+		for (uint i = 0; i < request.count; ++i) {
+			if (!fill( request.block + i ))
+				break;
+		}
+	}
+}
+/*----------------------------------------------------------------------------*/
+BlockCache::Line* BlockCache::find( uint block )
+{
+	const uint first = block - (block % BLOCKS_PER_LINE);
+	for (Line* line = m_buckets[(first / BLOCKS_PER_LINE) % BUCKET_COUNT];
+		line; line = line->next) {
+		if (line->first == first)
+			return line;
+	}
+	return NULL;
+}
+/*----------------------------------------------------------------------------*/
+BlockCache::Line* BlockCache::getLine( uint block )
+{
+	Line* line = NULL;
+
+	if (m_lineCount < m_capacity) {
+		void* frame = NULL;
+		if (FrameAllocator::instance().allocateAtKseg0( &frame, 1, PAGE_MIN ) == 1) {
+			line = new Line();
+			if (line) {
+				line->data = (char*)ADDR_TO_KSEG0( (uintptr_t)frame );
+				++m_lineCount;
+			} else {
+				FrameAllocator::instance().frameFree( frame, 1, PAGE_MIN );
+			}
+		}
+	}
+
+	/* reuse the least recently used line, clean lines first */
+	if (!line) {
+		while (true) {
+			Line* dirty = NULL;
+			for (List<Line*>::Iterator it = m_lru.rbegin();
+				it != m_lru.rend(); --it) {
+				if ((*it)->busy) continue;
+				if (!(*it)->dirty) {
+					line = *it;
+					break;
+				}
+				if (!dirty)
+					dirty = *it;
+			}
+			if (line) break;
+			if (!dirty)
+				return NULL;
+
+			PRINT_DEBUG ("Writing back line of block %u.\n", dirty->first);
+			if (!writeLine( dirty ))
+				return NULL;
+
+			/* the block might have been cached while writing */
+			Line* cached = find( block );
+			if (cached)
+				return cached;
+		}
+		PRINT_DEBUG ("Evicting line of block %u.\n", line->first);
+		unhash( line );
+	}
+
+	line->first   = block - (block % BLOCKS_PER_LINE);
+	line->valid   = 0;
+	line->dirty   = 0;
+	line->loading = 0;
+	line->busy    = 0;
+
+	Line*& bucket = m_buckets[(line->first / BLOCKS_PER_LINE) % BUCKET_COUNT];
+	line->next = bucket;
+	bucket = line;
+	line->prepend( &m_lru );
+	return line;
+}
+/*----------------------------------------------------------------------------*/
+void BlockCache::unhash( Line* line )
+{
+	Line** place = &m_buckets[(line->first / BLOCKS_PER_LINE) % BUCKET_COUNT];
+	while (*place != line) {
+		ASSERT (*place);
+		place = &(*place)->next;
+	}
+	*place = line->next;
+}
+/*----------------------------------------------------------------------------*/
+uint BlockCache::drop( uint count )
+{
+	uint freed = 0;
+	List<Line*>::Iterator it = m_lru.rbegin();
+	while (it != m_lru.rend() && freed < count) {
+		Line* line = *it--;
+		if (line->busy || line->dirty) continue;
+
+		unhash( line );
+		FrameAllocator::instance().frameFree(
+			(void*)ADDR_TO_USEG( (uintptr_t)line->data ), 1, PAGE_MIN );
+		delete line;
+		--m_lineCount;
+		++freed;
+	}
+	return freed;
+}
+/*----------------------------------------------------------------------------*/
+bool BlockCache::write( void* buffer, uint count, uint block, uint start_pos )
+{
+	const char* source = (const char*)buffer;
+	block    += start_pos / BLOCK_SIZE;
+	start_pos = start_pos % BLOCK_SIZE;
+
+	while (count) {
+		const uint part = min( count, BLOCK_SIZE - start_pos );
+		if (!writeBlock( source, block, start_pos, part ))
+			return false;
+		source += part;
+		count  -= part;
+		start_pos = 0;
+		++block;
+	}
+
+	InterruptDisabler inter;
+	if (m_dirtyBlocks > m_capacity * BLOCKS_PER_LINE / 2)
+		m_flushRequest.up();
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+bool BlockCache::writeBlock(
+	const char* buffer, uint block, uint start_pos, uint count )
+{
+	InterruptDisabler inter;
+
+	const uint32_t mask = 1 << (block % BLOCKS_PER_LINE);
+	Line* line = find( block );
+
+	if (!line && !(line = getLine( block ))) {
+		/* nothing to cache the block in, write it directly */
+		PRINT_DEBUG ("No line for block %u.\n", block);
+		return m_device->write( (void*)buffer, count, block, start_pos );
+	}
+
+	/* the rest of the block has to be valid */
+	if (count < BLOCK_SIZE && !fetch( line, block ))
+		return false;
+
+	if (!m_flusher) {
+		thread_t id;
+		m_flusher = KernelThread::create( &id, flushThread, this, TF_NEW_VMM );
+		PRINT_DEBUG ("Started flusher thread %u.\n", id);
+	}
+
+	line->prepend( &m_lru );
+
+	/* copying from the user memory might need frames, keep the line */
+	++line->busy;
+	while (line->loading & mask)
+		Thread::getCurrent()->yield();
+	memcpy( line->data + (block % BLOCKS_PER_LINE) * BLOCK_SIZE + start_pos,
+		buffer, count );
+	--line->busy;
+
+	line->valid |= mask;
+	if (!(line->dirty & mask)) {
+		line->dirty |= mask;
+		++m_dirtyBlocks;
+	}
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+bool BlockCache::writeLine( Line* line )
+{
+	const uint32_t dirty = line->dirty;
+	if (!dirty)
+		return true;
+
+	/* blocks written while the line is written get dirty again */
+	line->dirty = 0;
+	++line->busy;
+
+	bool success = true;
+	uint i = 0;
+	while (i < BLOCKS_PER_LINE) {
+		if (!(dirty & (1 << i))) {
+			++i;
+			continue;
+		}
+		uint end = i;
+		while (end < BLOCKS_PER_LINE && (dirty & (1 << end)))
+			++end;
+		m_dirtyBlocks -= end - i;
+
+		PRINT_DEBUG ("Writing %u blocks from %u.\n", end - i, line->first + i);
+		if (!m_device->write( line->data + i * BLOCK_SIZE,
+			(end - i) * BLOCK_SIZE, line->first + i, 0 )) {
+			/* keep the blocks dirty */
+			for (; i < end; ++i) {
+				if (!(line->dirty & (1 << i))) {
+					line->dirty |= 1 << i;
+					++m_dirtyBlocks;
+				}
+			}
+			success = false;
+		}
+		i = end;
+	}
+
+	--line->busy;
+	return success;
+}
+/*----------------------------------------------------------------------------*/
+bool BlockCache::flush()
+{
+	InterruptDisabler inter;
+
+	/* lines dirtied again while flushing are left to the flusher */
+	uint rounds = m_lineCount;
+	while (m_dirtyBlocks && rounds) {
+		/* write in ascending order, the disk head moves in one direction */
+		Line* next = NULL;
+		bool busy = false;
+		for (List<Line*>::Iterator it = m_lru.begin(); it != m_lru.end(); ++it) {
+			Line* line = *it;
+			if (!line->dirty) continue;
+			if (line->busy) {
+				busy = true;
+				continue;
+			}
+			if (!next || line->first < next->first)
+				next = line;
+		}
+
+		if (!next) {
+			if (!busy) break;
+			Thread::getCurrent()->yield();
+			continue;
+		}
+
+		if (!writeLine( next ))
+			return false;
+		--rounds;
+	}
+	return m_device->flush();
+}
+/*----------------------------------------------------------------------------*/
+void* BlockCache::flushThread( void* cache )
+{
+	((BlockCache*)cache)->flushLoop();
+	return NULL;
+}
+/*----------------------------------------------------------------------------*/
+void BlockCache::flushLoop()
+{
+	while (true) {
+		m_flushRequest.downTimeout( 1, Time( FLUSH_INTERVAL, 0 ) );
+		if (!m_dirtyBlocks) continue;
+
+		PRINT_DEBUG ("Flushing %u dirty blocks.\n", m_dirtyBlocks);
+		flush();
+	}
+}
+/*----------------------------------------------------------------------------*/
+size_t BlockCache::size()
+{
+	return m_device->size();
+}
+/*----------------------------------------------------------------------------*/
+void BlockCache::handleInterrupt()
+{
+	m_device->handleInterrupt();
+}
+/*----------------------------------------------------------------------------*/
+BlockCache::~BlockCache()
+{
+	InterruptDisabler inter;
+	flush();
+	drop();
+	ASSERT (m_lru.empty());
+}
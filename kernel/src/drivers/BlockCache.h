@@ -0,0 +1,314 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief BlockCache class declaration.
+ *
+ * Block cache keeps recently used disk blocks in memory, so repeated reads
+ * of the same data do not have to wait for the disk and writes do not have
+ * to wait for it at all.
+ */
+#pragma once
+
+#include "api.h"
+#include "DiskDevice.h"
+#include "structures/ListInsertable.h"
+#include "synchronization/Semaphore.h"
+
+class Thread;
+
+/*!
+ * @class BlockCache BlockCache.h "drivers/BlockCache.h"
+ * @brief LRU cache of disk blocks in front of another DiskDevice.
+ *
+ * Cache is made of lines, every line is one PAGE_MIN frame holding
+ * BLOCKS_PER_LINE consecutive (aligned) blocks, each of them is read only
+ * when requested. Frames are allocated on demand up to the capacity given
+ * at construction, then the least recently used line is reused.
+ * Lines that are not in use are returned to the FrameAllocator when memory
+ * runs out, see reclaim().
+ *
+ * Blocks are read from the underlying device straight into the line
+ * frames (they are in KSEG0). Prefetch requests are queued and served
+ * by a kernel thread, so blocks are read ahead while the requester runs.
+ *
+ * Long runs of whole blocks that are not cached (at least BYPASS_BLOCKS)
+ * skip the cache, the device transfers them directly to the destination
+ * and the cache is not flushed by a single large read.
+ *
+ * Writes only modify the cached blocks and mark them dirty. Dirty blocks
+ * are written back by a flusher thread every FLUSH_INTERVAL or as soon as
+ * more than half of the cache is dirty, when their line is evicted and
+ * on flush(). Consecutive dirty blocks of a line are written by a single
+ * device request.
+ */
+class BlockCache: public DiskDevice, public ListInsertable<BlockCache>
+{
+public:
+	/*! @brief Part of the RAM the cache may use (1/RAM_FRACTION). */
+	static const uint RAM_FRACTION = 16;
+
+	/*! @brief Shortest run of uncached blocks that is not cached. */
+	static const uint BYPASS_BLOCKS = 32;
+
+	/*! @brief Longest time (in seconds) dirty blocks wait for the flusher. */
+	static const uint FLUSH_INTERVAL = 1;
+
+	/*!
+	 * @brief Creates cache in front of the device.
+	 * @param device Cached device.
+	 * @param capacity Maximum number of bytes the cache may use.
+	 */
+	BlockCache( DiskDevice* device, size_t capacity );
+
+	/*!
+	 * @brief Reads data through the cache.
+	 * @param buffer Place to store the data.
+	 * @param count Number of bytes to read.
+	 * @param block Starting block.
+	 * @param start_pos Offset of the first requested byte from 
+	 * 	the start of the block.
+	 * @return @a True on success, @a false otherwise.
+	 */
+	bool read( void* buffer, uint count, uint block, uint start_pos );
+
+	/*!
+	 * @brief Writes data to the cache, the device is written later.
+	 * @param buffer Data to write.
+	 * @param count Number of bytes to write.
+	 * @param block Starting block.
+	 * @param start_pos Offset of the first byte from the start of the block.
+	 * @return @a True on success, @a false otherwise.
+	 *
+	 * Blocks are written directly to the device if there is no line
+	 * to cache them in.
+	 */
+	bool write( void* buffer, uint count, uint block, uint start_pos );
+
+	/*!
+	 * @brief Writes all dirty blocks to the device and flushes it.
+	 * @return @a True on success, @a false otherwise.
+	 */
+	bool flush();
+
+	/*!
+	 * @brief Queues the blocks to be read into the cache.
+	 * @param block First block.
+	 * @param count Number of blocks.
+	 *
+	 * Request is dropped if the queue is full.
+	 */
+	void prefetch( uint block, uint count );
+
+	/*! @brief Gets size of the cached device. */
+	size_t size();
+
+	/*! @brief Interrupts are handled by the cached device. */
+	void handleInterrupt();
+
+	/*! @brief Gets number of blocks that were found in the cache. */
+	inline uint hits() const { return m_hits; };
+
+	/*! @brief Gets number of blocks that had to be read from the device. */
+	inline uint misses() const { return m_misses; };
+
+	/*! @brief Gets number of blocks read ahead by the prefetch thread. */
+	inline uint prefetched() const { return m_prefetched; };
+
+	/*! @brief Gets number of blocks waiting to be written to the device. */
+	inline uint dirty() const { return m_dirtyBlocks; };
+
+	/*!
+	 * @brief Frees lines of caches that are not in use, least recently
+	 * 	used first.
+	 * @param count Maximum number of frames to free.
+	 * @return Number of frames returned to the FrameAllocator.
+	 */
+	static uint reclaim( uint count );
+
+	/*! @brief Returns all frames. */
+	~BlockCache();
+
+private:
+	/*! @brief Number of blocks stored in one line (frame). */
+	static const uint BLOCKS_PER_LINE = 16;
+
+	/*! @brief Number of hash buckets used to find lines. */
+	static const uint BUCKET_COUNT = 64;
+
+	/*! @brief Maximum number of waiting prefetch requests. */
+	static const uint QUEUE_SIZE = 8;
+
+	/*! @brief One frame of cached blocks. */
+	struct Line: public ListInsertable<Line> {
+		uint first;               /*!< First block of the line.           */
+		uint32_t valid;           /*!< Bit mask of blocks that were read. */
+		uint32_t dirty;           /*!< Bit mask of blocks not written yet.*/
+		uint32_t loading;         /*!< Bit mask of blocks being read.     */
+		uint busy;                /*!< Number of threads using the frame. */
+		char* data;               /*!< KSEG0 address of the frame.        */
+		Line* next;               /*!< Next line in the hash bucket.      */
+	};
+
+	/*! @brief Blocks to read ahead. */
+	struct Request {
+		uint block;               /*!< First block.                       */
+		uint count;               /*!< Number of blocks.                  */
+	};
+
+	DiskDevice* m_device;         /*!< Cached device.                     */
+	uint m_capacity;              /*!< Maximum number of lines.           */
+	uint m_lineCount;             /*!< Number of lines with frames.       */
+	uint m_hits;                  /*!< Blocks found in the cache.         */
+	uint m_misses;                /*!< Blocks read from the device.       */
+	uint m_prefetched;            /*!< Blocks read ahead.                 */
+	uint m_dirtyBlocks;           /*!< Blocks waiting to be written.      */
+	List<Line*> m_lru;            /*!< Lines, most recently used first.   */
+	Line* m_buckets[BUCKET_COUNT];/*!< Hash of lines by their first block.*/
+
+	Thread* m_worker;             /*!< Prefetch thread, NULL until needed.*/
+	Semaphore m_pending;          /*!< Number of queued requests.         */
+	uint m_queueStart;            /*!< First queued request.              */
+	uint m_queueCount;            /*!< Number of queued requests.         */
+	Request m_queue[QUEUE_SIZE];  /*!< Circular queue of requests.        */
+
+	Thread* m_flusher;            /*!< Write back thread, NULL until used.*/
+	Semaphore m_flushRequest;     /*!< Wakes the flusher before timeout.  */
+
+	/*!
+	 * @brief Reads part of one block.
+	 * @param buffer Place to store the data.
+	 * @param block The block.
+	 * @param start_pos Offset of the first byte in the block.
+	 * @param count Number of bytes (not crossing the end of the block).
+	 * @return @a True on success, @a false otherwise.
+	 */
+	bool readBlock( char* buffer, uint block, uint start_pos, uint count );
+
+	/*!
+	 * @brief Writes part of one block to the cache.
+	 * @param buffer Data to write.
+	 * @param block The block.
+	 * @param start_pos Offset of the first byte in the block.
+	 * @param count Number of bytes (not crossing the end of the block).
+	 * @return @a True on success, @a false otherwise.
+	 *
+	 * Blocks that are written only partially are read first.
+	 */
+	bool writeBlock( const char* buffer, uint block, uint start_pos, uint count );
+
+	/*!
+	 * @brief Writes dirty blocks of the line to the device.
+	 * @param line The line.
+	 * @return @a True on success, @a false otherwise.
+	 *
+	 * Every run of consecutive dirty blocks is written by one request.
+	 */
+	bool writeLine( Line* line );
+
+	/*! @brief Writes dirty blocks periodically, never returns. */
+	void flushLoop();
+
+	/*!
+	 * @brief Flusher thread entry point.
+	 * @param cache BlockCache to serve.
+	 */
+	static void* flushThread( void* cache );
+
+	/*!
+	 * @brief Counts consecutive blocks that are not cached.
+	 * @param block First block.
+	 * @param limit Maximum number of blocks to check.
+	 * @return Number of uncached blocks starting at @a block.
+	 */
+	uint uncached( uint block, uint limit );
+
+	/*!
+	 * @brief Reads the block into the line unless it is already there.
+	 * @param line Line of the block.
+	 * @param block The block.
+	 * @return @a True on success, @a false otherwise.
+	 */
+	bool fetch( Line* line, uint block );
+
+	/*!
+	 * @brief Reads the block into the cache unless it is already there.
+	 * @param block The block.
+	 * @return @a True if the block is cached, @a false otherwise.
+	 */
+	bool fill( uint block );
+
+	/*! @brief Serves prefetch requests, never returns. */
+	void prefetchLoop();
+
+	/*!
+	 * @brief Prefetch thread entry point.
+	 * @param cache BlockCache to serve.
+	 */
+	static void* prefetchThread( void* cache );
+
+	/*!
+	 * @brief Finds line containing the block.
+	 * @param block The block.
+	 * @return Pointer to the line, NULL if the block is not cached.
+	 */
+	Line* find( uint block );
+
+	/*!
+	 * @brief Gets line for the block that is not cached.
+	 * @param block The block.
+	 * @return New or the least recently used line, NULL if there is none.
+	 *
+	 * Clean lines are reused first, dirty line is written back before
+	 * it is reused. Returns the line of the block if it was added while
+	 * the dirty line was written.
+	 */
+	Line* getLine( uint block );
+
+	/*!
+	 * @brief Removes line from the hash.
+	 * @param line The line.
+	 */
+	void unhash( Line* line );
+
+	/*!
+	 * @brief Frees lines that are not in use and not dirty, least
+	 * 	recently used first.
+	 * @param count Maximum number of frames to free.
+	 * @return Number of freed frames.
+	 */
+	uint drop( uint count = (uint)-1 );
+
+	/*! @brief No copying. */
+	BlockCache( const BlockCache& );
+
+	/*! @brief No assigning. */
+	BlockCache& operator = ( const BlockCache& );
+
+	/*! @brief All existing caches, used by reclaim(). */
+	static List<BlockCache*>& caches()
+		{ static List<BlockCache*> list; return list; }
+};
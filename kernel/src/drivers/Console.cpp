@@ -31,9 +31,14 @@
 
 #include "Console.h"
 #include "proc/Thread.h"
+#include "proc/KernelThread.h"
+#include "InterruptDisabler.h"
 
 //#define CONSOLE_DEBUG
 
+/*! @brief Char sent by the backspace key. */
+#define DELETE 127
+
 #ifndef CONSOLE_DEBUG
 #define PRINT_DEBUG(...)
 #else
@@ -42,62 +47,239 @@
   printf(ARGS);
 #endif
 
-size_t Console::outputString(const char* str) const
+/*! @brief Number of characters the drainer writes with interrupts disabled. */
+#define DRAIN_CHUNK 64
+
+size_t Console::outputChar(char c)
+{
+	if (!m_drainer)
+		return OutputCharacterDevice::outputChar(c);
+
+	InterruptDisabler inter;
+	return logChar(c) ? 1 : 0;
+}
+/*----------------------------------------------------------------------------*/
+size_t Console::outputString(const char* str, bool wait)
+{
+	const char *  it = str; /* find the end of the string */
+	while (*it) ++it;
+	return outputData(str, it - str, wait);
+}
+/*----------------------------------------------------------------------------*/
+size_t Console::outputData(const char* data, size_t count, bool wait)
 {
-	const char *  it = str; /* fly through the string */
-	
-	for (;*it;++it)
+	if (!m_drainer) {
+		for (size_t i = 0; i < count; ++i)
+		{
+			OutputCharacterDevice::outputChar(data[i]);
+		}
+		return count;
+	}
+
+	InterruptDisabler inter;
+	size_t accepted = 0;
+	for (size_t i = 0; i < count; ++i)
 	{
-		outputChar(*it);
+		while (wait && m_logCount == LOG_SIZE)
+			Thread::getCurrent()->yield();
+		if (logChar(data[i])) ++accepted;
 	}
+	return accepted;
+}
+/*----------------------------------------------------------------------------*/
+bool Console::logChar(char c)
+{
+	if (m_logCount == LOG_SIZE) {
+		++m_dropped;
+		return false;
+	}
+	m_log[(m_logStart + m_logCount) % LOG_SIZE] = c;
+
+	/* drainer sleeps only when the buffer is empty */
+	if (m_logCount++ == 0)
+		m_logReady.up();
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+uint Console::drain(uint max)
+{
+	uint count = 0;
+	while (m_logCount && count < max) {
+		OutputCharacterDevice::outputChar(m_log[m_logStart]);
+		m_logStart = (m_logStart + 1) % LOG_SIZE;
+		--m_logCount;
+		++count;
+	}
+	return count;
+}
+/*----------------------------------------------------------------------------*/
+void Console::reportDropped()
+{
+	if (m_dropped == m_reported)
+		return;
+
+	/* printf would append to the buffer again */
+	char number[11];
+	uint pos = sizeof(number);
+	uint dropped = m_dropped - m_reported;
+	number[--pos] = '\0';
+	do {
+		number[--pos] = '0' + dropped % 10;
+		dropped /= 10;
+	} while (dropped);
+	m_reported = m_dropped;
+
+	const char* parts[] = { "\n[console: ", number + pos, " chars dropped]\n" };
+	for (uint i = 0; i < sizeof(parts) / sizeof(parts[0]); ++i)
+		for (const char* it = parts[i]; *it; ++it)
+			OutputCharacterDevice::outputChar(*it);
+}
+/*----------------------------------------------------------------------------*/
+bool Console::startDrainer()
+{
+	InterruptDisabler inter;
+	if (m_drainer)
+		return true;
+
+	thread_t id;
+	Thread* drainer = KernelThread::create(&id, drainerThread, this);
+	if (!drainer)
+		return false;
+	drainer->setVMM(NULL);
+	PRINT_DEBUG ("Started drainer thread %u.\n", id);
+	m_drainer = drainer;
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+void Console::flush()
+{
+	InterruptDisabler inter;
+	drain(LOG_SIZE);
+	reportDropped();
+}
+/*----------------------------------------------------------------------------*/
+void* Console::drainerThread(void* data)
+{
+	Console& console = *(Console*)data;
+	while (true) {
+		console.m_logReady.down();
 
-	return it - str; /* finish - start should give the number of chars */
+		/* short chunks, interrupts are not disabled for long */
+		uint written;
+		do {
+			InterruptDisabler inter;
+			written = console.drain(DRAIN_CHUNK);
+			if (!console.m_logCount)
+				console.reportDropped();
+		} while (written);
+	}
+	return NULL;
 }
 /*----------------------------------------------------------------------------*/
 char Console::readChar()
 {
-	/* buffer is empty */
-	while (count() == 0) { 
+	InterruptDisabler inter;
+	waitForInput();
+	const char c = takeChar();
+	wakeReader();
+	return c;
+}
+/*----------------------------------------------------------------------------*/
+int Console::tryReadChar()
+{
+	InterruptDisabler inter;
+	if (!readable())
+		return EWOULDBLOCK;
+	return takeChar();
+}
+/*----------------------------------------------------------------------------*/
+ssize_t Console::readString(char* str, const size_t len)
+{
+	if (len == 0) return EINVAL;
+
+	InterruptDisabler inter;
+	waitForInput();
+
+	size_t count = 0;
+	while (readable() && count < len - 1) {
+		const char c = takeChar();
+		if (c == '\n') break;
+		str[count++] = c;
+	}
+	str[count] = '\0';
+
+	wakeReader();
+	return count;
+}
+/*----------------------------------------------------------------------------*/
+void Console::waitForInput()
+{
+	/* no finished line */
+	while (readable() == 0) {
 		Thread * thread = Thread::getCurrent();
 
 		/* remove from Timer and Scheduler */
 		thread->block();
 
 		/* add to my list */
-		thread->append(&m_waitList); 
+		thread->append(&m_waitList);
 
 		/* set status and rest */
 		thread->setStatus(Thread::BLOCKED);
 		thread->yield();
 	}
-	return getChar();
 }
 /*----------------------------------------------------------------------------*/
-ssize_t Console::readString(char* str, const size_t len)
+char Console::takeChar()
 {
-	if (len == 0) return EINVAL;
-	char* c = str;
-	while ( (*c = readChar())  != '\n' 
-			&&  (unsigned int)(c - str) < (len - 1) ) {
-		++c;
+	ASSERT (readable());
+	const char c = m_input[m_inputStart];
+	m_inputStart = (m_inputStart + 1) % INPUT_SIZE;
+	--m_inputCount;
+	return c;
+}
+/*----------------------------------------------------------------------------*/
+void Console::wakeReader()
+{
+	/* there is someone waiting for the rest */
+	if (readable() && m_waitList.size()) {
+		Thread * thr = m_waitList.getFront();
+		PRINT_DEBUG ("Unblocking thread %u.\n", thr->id());
+		ASSERT (thr->status() == Thread::BLOCKED);
+		/* resume normal operation */
+		thr->resume();
 	}
-	*c = '\0';
-	return c - str;
 }
 /*----------------------------------------------------------------------------*/
 void Console::handleInterrupt()
 {
 	/* read character */
-	insert();
+	const char c = inputChar();
 
 	PRINT_DEBUG ("Console interrupt, waiting threads: %u\n", m_waitList.size());
 
-	/* there is someone waiting for this char */
-	if (m_waitList.size()) {
-		Thread * thr = m_waitList.getFront();
-		PRINT_DEBUG ("Unblocking thread %u.\n", thr->id());
-		ASSERT (thr->status() == Thread::BLOCKED);
-		/* resume normal operation */
-		thr->resume();
+	/* erase the last char of the unfinished line */
+	if (c == '\b' || c == DELETE) {
+		if (m_lineLength) {
+			--m_lineLength;
+			--m_inputCount;
+			outputString("\b \b");
+		}
+		return;
+	}
+
+	/* no space, the line has to be finished first */
+	if (m_inputCount == INPUT_SIZE)
+		return;
+
+	m_input[(m_inputStart + m_inputCount) % INPUT_SIZE] = c;
+	++m_inputCount;
+	++m_lineLength;
+	outputChar(c);
+
+	/* finish the line, full buffer finishes it too so readers can't lock */
+	if (c == '\n' || m_inputCount == INPUT_SIZE) {
+		m_lineLength = 0;
+		wakeReader();
 	}
 }
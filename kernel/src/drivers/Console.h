@@ -28,13 +28,17 @@
  * @brief Console class declaration
  *
  * IO class Console handles text (character) input/output.
+ * Output goes through a ring buffer drained by a kernel thread,
+ * input goes through a line discipline.
  */
 #pragma once
 
 #include "OutputCharacterDevice.h"
 #include "InputCharacterDevice.h"
 #include "InterruptHandler.h"
+#include "api.h"
 #include "structures/List.h"
+#include "synchronization/Semaphore.h"
 
 class Thread;
 typedef List<Thread *> ThreadList;
@@ -45,6 +49,19 @@ typedef List<Thread *> ThreadList;
  *
  * Console handles character output and keyboard input
  * inherits classes OutputCharacterDevice and InputCharacterDevice
+ *
+ * Once startDrainer() is called, output characters are only appended to
+ * a ring buffer (with interrupts disabled) and a kernel thread writes
+ * them to the device. Writers never wait: characters that do not fit
+ * are dropped and counted, the drainer reports their number when it
+ * catches up. Only user output waits for space, so processes printing
+ * a lot are slowed down instead of losing their output. flush() writes the buffer directly, it is used before
+ * the machine halts or panics.
+ *
+ * Input is edited in the interrupt handler: chars are echoed, backspace
+ * removes the last char of the unfinished line. Readers only see
+ * finished lines, so they are woken once per line instead of once per
+ * keystroke.
  */
 class Console:
 	public OutputCharacterDevice, public InputCharacterDevice, public InterruptHandler
@@ -53,20 +70,64 @@ public:
 	/*! @brief Initializes parent classes for input and output. */
 	Console(char* outAddress = NULL, char* inAddress = NULL):
 		OutputCharacterDevice(outAddress),
-		InputCharacterDevice(inAddress) {};
-	
-	/*! @brief Prints string on associated device.
+		InputCharacterDevice(inAddress),
+		m_logStart( 0 ), m_logCount( 0 ), m_dropped( 0 ), m_reported( 0 ),
+		m_drainer( NULL ), m_logReady( 0 ),
+		m_inputStart( 0 ), m_inputCount( 0 ), m_lineLength( 0 ) {};
+
+	/*! @brief Size of the output ring buffer. */
+	static const uint LOG_SIZE = 16384;
+
+	/*! @brief Size of the input ring buffer. */
+	static const uint INPUT_SIZE = 1024;
+
+	/*! @brief Prints char on associated device (buffered).
+	 * @param c character to print
+	 * @return number of accepted chars (0 if it was dropped)
+	 */
+	size_t outputChar(char c);
+
+	/*! @brief Prints string on associated device (buffered).
 	 * @param str pointer to the first char
-	 * @return number of printed chars
+	 * @param wait Wait for space instead of dropping chars (user output).
+	 * @return number of accepted chars
+	 */
+	size_t outputString(const char* str, bool wait = false);
+
+	/*! @brief Prints @a count chars on associated device (buffered).
+	 * @param data pointer to the first char
+	 * @param count number of chars to print, zeros included
+	 * @param wait Wait for space instead of dropping chars (user output).
+	 * @return number of accepted chars
+	 */
+	size_t outputData(const char* data, size_t count, bool wait = false);
+
+	/*! @brief Starts the thread writing buffered output to the device.
+	 * @return @a True if output is buffered from now on.
 	 */
-	size_t outputString(const char* str) const;
+	bool startDrainer();
+
+	/*! @brief Writes all buffered output to the device, does not block. */
+	void flush();
 
-	/*! @brief Gets next character in the buffer. (BLOCKING)
+	/*! @brief Gets number of characters dropped because the buffer was full. */
+	inline uint dropped() const { return m_dropped; };
+
+	/*! @brief Gets next character of finished lines. (BLOCKING)
 	 * @return Read character
 	 */
 	char readChar();
 
-	/*! @brief Reads and stores multiple chars from the input.
+	/*! @brief Gets next character of finished lines if there is one.
+	 * @return Read character, EWOULDBLOCK if there is none.
+	 */
+	int tryReadChar();
+
+	/*! @brief Reads and stores multiple chars from the input. (BLOCKING)
+	 *
+	 * Waits for a finished line and reads it up to '\\n', which is
+	 * consumed but not stored. Rest of a line longer than @a len stays
+	 * for the next read.
 	 * @param str Place to store the characters.
 	 * @param len Maximum number of characters to store, including ending \\0.
 	 * @return Number of read characters
@@ -75,11 +136,61 @@ public:
 
 	/*! @brief Handles keyboard interrupts.
 	 *
-	 * Fills the buffer, wakes the threads.
+	 * Edits and echoes the current line, wakes a reader when it is finished.
 	 */
 	void handleInterrupt();
 
 private:
 	/*! @brief List of threads wating for input */
 	ThreadList m_waitList;
+
+	char m_log[LOG_SIZE];      /*!< Ring buffer of output characters.   */
+	uint m_logStart;           /*!< First buffered character.           */
+	uint m_logCount;           /*!< Number of buffered characters.      */
+	uint m_dropped;            /*!< Characters dropped when full.       */
+	uint m_reported;           /*!< Dropped characters reported so far. */
+	Thread* m_drainer;         /*!< Drainer thread, NULL until started. */
+	Semaphore m_logReady;      /*!< Signalled when the buffer fills up. */
+
+	char m_input[INPUT_SIZE];  /*!< Ring buffer of input characters.    */
+	uint m_inputStart;         /*!< First unread character.             */
+	uint m_inputCount;         /*!< Characters in the buffer.           */
+	uint m_lineLength;         /*!< Characters of the unfinished line.  */
+
+	/*! @brief Gets number of characters of finished lines. */
+	inline uint readable() const { return m_inputCount - m_lineLength; };
+
+	/*! @brief Blocks until there is a finished line, interrupts have to be
+	 * disabled.
+	 */
+	void waitForInput();
+
+	/*! @brief Removes the first readable character, interrupts have to be
+	 * disabled.
+	 * @return The character.
+	 */
+	char takeChar();
+
+	/*! @brief Wakes one waiting reader if there is anything to read. */
+	void wakeReader();
+
+	/*! @brief Appends char to the buffer, interrupts have to be disabled.
+	 * @param c The char.
+	 * @return @a True if there was space for it.
+	 */
+	bool logChar(char c);
+
+	/*! @brief Moves characters from the buffer to the device.
+	 * @param max Maximum number of characters (interrupts are disabled).
+	 * @return Number of written characters.
+	 */
+	uint drain(uint max);
+
+	/*! @brief Writes number of dropped characters if there are new ones. */
+	void reportDropped();
+
+	/*! @brief Drainer thread, never returns.
+	 * @param console Console to drain.
+	 */
+	static void* drainerThread(void* console);
 };
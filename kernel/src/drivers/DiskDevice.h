@@ -33,6 +33,9 @@
 #pragma once
 #include "InterruptHandler.h"
 
+/*! @brief Size of the disk block (sector) in bytes. */
+#define BLOCK_SIZE 512
+
 /*!
  * @class DiskDevice DiskDevice.h "drivers/DiskDevice.h"
  * @brief Abstract class that provides handling of the disk devices.
@@ -60,6 +63,25 @@ public:
 	 */
 	virtual bool write( void* buffer, uint count, uint block, uint start_pos );
 
+	/*!
+	 * @brief Hints that the blocks will be read soon.
+	 * @param block First block.
+	 * @param count Number of blocks.
+	 *
+	 * Devices that can read ahead do so in the background, the caller
+	 * is never blocked. Default implementation does nothing.
+	 */
+	virtual void prefetch( uint block, uint count ) {};
+
+	/*!
+	 * @brief Writes all data the device holds in memory to the disk.
+	 * @return @a True if everything was written, @a false otherwise.
+	 *
+	 * Default implementation does nothing, devices without any write
+	 * cache write data before write() returns.
+	 */
+	virtual bool flush() { return true; };
+
 	/*!
 	 * @brief Gets number of bytes the device can store.
 	 * @return Number of bytes the device can store.
@@ -0,0 +1,64 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief DiskQueue class implementation.
+ */
+#include "DiskQueue.h"
+
+/*----------------------------------------------------------------------------*/
+void DiskQueue::insert( DiskRequest* request )
+{
+	ASSERT (request && request->count);
+
+	DiskRequest** place = &m_first;
+	while (*place && (*place)->sector <= request->sector)
+		place = &(*place)->next;
+
+	request->next = *place;
+	*place = request;
+	++m_size;
+}
+/*----------------------------------------------------------------------------*/
+DiskRequest* DiskQueue::take( uint head )
+{
+	DiskRequest** place = &m_first;
+	while (*place && (*place)->sector < head)
+		place = &(*place)->next;
+
+	/* nothing ahead, sweep again from the lowest sector */
+	if (!*place)
+		place = &m_first;
+
+	DiskRequest* request = *place;
+	if (request) {
+		*place = request->next;
+		request->next = NULL;
+		--m_size;
+	}
+	return request;
+}
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,96 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief DiskQueue class declaration.
+ *
+ * Queue of pending disk requests ordered for the C-LOOK elevator.
+ */
+#pragma once
+
+#include "api.h"
+
+class Thread;
+
+/*!
+ * @struct DiskRequest DiskQueue.h "drivers/DiskQueue.h"
+ * @brief Run of consecutive sectors to transfer.
+ *
+ * Request is owned by the caller (usually on its stack), the driver moves
+ * @a sector, @a count and @a addresses forward as sectors are transferred.
+ */
+struct DiskRequest
+{
+	uint sector;                /*!< Next sector to transfer.             */
+	uint count;                 /*!< Number of sectors left.              */
+	const uintptr_t* addresses; /*!< Physical address of every sector.    */
+	bool write;                 /*!< Write to the disk instead of read.   */
+	bool failed;                /*!< Device reported an error.            */
+	Thread* owner;              /*!< Thread waiting for the request.      */
+	DiskRequest* next;          /*!< Next request in the queue.           */
+};
+
+/*!
+ * @class DiskQueue DiskQueue.h "drivers/DiskQueue.h"
+ * @brief Pending disk requests sorted by sector.
+ *
+ * Requests are taken in one direction only (C-LOOK): the next one is the
+ * first at or after the head position, when there is none the head
+ * returns to the lowest requested sector. Requests for adjacent sectors
+ * therefore follow each other without a seek, whichever process
+ * issued them.
+ *
+ * Queue does no locking, users have to disable interrupts.
+ */
+class DiskQueue
+{
+public:
+	/*! @brief Creates empty queue. */
+	DiskQueue(): m_first( NULL ), m_size( 0 ) {};
+
+	/*!
+	 * @brief Inserts request into the queue.
+	 * @param request Request with at least one sector left.
+	 *
+	 * Request is placed after the requests for the same sector.
+	 */
+	void insert( DiskRequest* request );
+
+	/*!
+	 * @brief Removes the request to serve next.
+	 * @param head Sector following the last transferred one.
+	 * @return First request at or after @a head, the lowest one if there
+	 * 	is none, NULL if the queue is empty.
+	 */
+	DiskRequest* take( uint head );
+
+	/*! @brief Gets number of queued requests. */
+	inline uint size() const { return m_size; };
+
+private:
+	DiskRequest* m_first;       /*!< Request with the lowest sector.      */
+	uint m_size;                /*!< Number of queued requests.           */
+};
@@ -32,15 +32,14 @@
  */
 #pragma once
 
-#define BUFF_SIZE 128
-#include "structures/Buffer.h"
+#include "types.h"
 
 /*!
  * @class InputCharacterDevice InputCharacterDevice.h "drivers/InputCharacterDevice.h"
- * @brief Buffered character input class.
+ * @brief Unbuffered character input class.
  *
- * Class reads character from given address and stores them in the buffer.
- * It needs to take kick in the form of insert function to do that.
+ * Class reads character from given address, buffering is left to
+ * the line discipline in Console.
  */
 class InputCharacterDevice
 {
@@ -48,23 +47,12 @@ public:
 	/*! @brief Constructor sets the reading address */
 	InputCharacterDevice(char * address):m_inputAddress(address){};
 
-	/*! @brief Reads one stored char from the buffer */
-	inline char getChar() 
-		{ ASSERT (m_buffer.count()); return m_buffer.getFirst(); };
-	
-	/*! @brief Outputs buffer size */
-	inline size_t size() const { return BUFF_SIZE; };
-
-	/*! @brief Outputs current buffer usege */
-	inline size_t count() const { return m_buffer.count(); };
-
-	/*! @brief Kick to read value from input and put it to the buffer */
-	inline size_t insert() {	return m_buffer.append( *m_inputAddress );	};
+	/*! @brief Reads char from the device, call only when it has one.
+	 * @return Read char.
+	 */
+	inline char inputChar() const { return *m_inputAddress; };
 
 protected:
 	/*! device address */
 	char * m_inputAddress;
-
-	/*! buffer of the read characters */
-	Buffer<char, BUFF_SIZE> m_buffer;
 };
@@ -36,8 +36,10 @@
 #include "tools.h"
 #include "InterruptDisabler.h"
 #include "proc/Thread.h"
-#include "synchronization/MutexLocker.h"
 #include "address.h"
+#include "Pointer.h"
+#include "mem/IVirtualMemoryMap.h"
+#include "Tracer.h"
 
 //#define DISC_DEBUG
 
@@ -51,91 +53,201 @@
 
 bool MsimDisk::read( void* buffer, uint count, uint secno, uint start_pos )
 {
-	InterruptDisabler inter;
-	MutexLocker guard(m_guard);
-
-	PRINT_DEBUG ("Started read status: %x.\n", m_registers[STATUS]);
-	
-	ASSERT (!pending());
-	//if (pending()) return false;
+	return access( (char*)buffer, count, secno, start_pos, false );
+}
+/*----------------------------------------------------------------------------*/
+bool MsimDisk::write( void* buffer, uint count, uint secno, uint start_pos )
+{
+	return access( (char*)buffer, count, secno, start_pos, true );
+}
+/*----------------------------------------------------------------------------*/
+bool MsimDisk::access(
+	char* data, uint count, uint secno, uint start_pos, bool write )
+{
+	if (!ADDR_IN_USEG((uintptr_t)data))
+		return accessChunks( NULL, data, count, secno, start_pos, write );
 
-	uint copy_count = 0;
-	char* target = (char*)buffer;
-	
+	/* the device transfers to the frames directly, they must not be freed
+	 * (vma_free by another thread, process exit) before it is done */
+	Pointer<IVirtualMemoryMap> vmm = IVirtualMemoryMap::getCurrent();
+	if (!vmm)
+		return false;
+	vmm->pin();
+	const bool success = accessChunks( vmm.data(), data, count, secno,
+		start_pos, write );
+	vmm->unpin();
+	return success;
+}
+/*----------------------------------------------------------------------------*/
+bool MsimDisk::accessChunks( IVirtualMemoryMap* vmm,
+	char* data, uint count, uint secno, uint start_pos, bool write )
+{
+	/* long transfers are queued in chunks, other requests may be served
+	 * in between if the elevator passes them */
 	while (count) {
-		/* from the begining and large enough block read directly */
-		if ( start_pos == 0 && count >= BLOCK_SIZE && ADDR_IN_KSEG0(target) ) {
-			PRINT_DEBUG ("Reading whole block to buffer %p.\n", target);
-			diskOp( secno, ADDR_TO_USEG((uintptr_t)target), OP_READ ); 
-			copy_count = BLOCK_SIZE;
-		} else {
-			PRINT_DEBUG ("Partial read to internal buffer %p.\n", m_buffer);	
-			diskOp( secno, ADDR_TO_USEG((uintptr_t)m_buffer), OP_READ );
-			copy_count = min( count, BLOCK_SIZE - start_pos );
-			memcpy( target, m_buffer + start_pos, copy_count );
+		uintptr_t addresses[CHUNK_SECTORS];
+		bool direct[CHUNK_SECTORS];
+		uint sectors = 0, bounced = 0;
+
+		/* from the begining and large enough block transfer directly */
+		for (uint done = 0, offset = start_pos;
+		    done < count && sectors < CHUNK_SECTORS; ++sectors) {
+			const uint part = min( count - done, BLOCK_SIZE - offset );
+			direct[sectors] = (part == BLOCK_SIZE)
+				&& dmaAddress( data + done, vmm, addresses[sectors] );
+			if (!direct[sectors])
+				++bounced;
+			done += part;
+			offset = 0;
+		}
+
+		/* partial sectors go through a kernel buffer */
+		char* bounce = NULL;
+		if (bounced) {
+			bounce = (char*)malloc( bounced * BLOCK_SIZE );
+			if (!bounce) return false;
+			for (uint i = 0, j = 0; i < sectors; ++i)
+				if (!direct[i])
+					addresses[i] =
+						ADDR_TO_USEG((uintptr_t)(bounce + BLOCK_SIZE * j++));
+		}
+
+		/* written data have to be in the buffer, partial sectors are
+		 * read first to keep the rest of their contents */
+		if (write && bounced) {
+			uint pos = start_pos, done = 0;
+			for (uint i = 0, j = 0; i < sectors; ++i) {
+				const uint part = min( count - done, BLOCK_SIZE - pos );
+				if (!direct[i]) {
+					char* sector = bounce + BLOCK_SIZE * j++;
+					if (part != BLOCK_SIZE && !read( sector, BLOCK_SIZE, secno + i, 0 )) {
+						free( bounce );
+						return false;
+					}
+					memcpy( sector + pos, data + done, part );
+				}
+				done += part;
+				pos = 0;
+			}
+		}
+
+		PRINT_DEBUG ("%s %u sectors from %u (%u bounced).\n",
+			write ? "Writing" : "Reading", sectors, secno, bounced);
+		DiskRequest request = { secno, sectors, addresses, write, false, NULL, NULL };
+		const bool success = transfer( request );
+
+		for (uint i = 0, j = 0; i < sectors; ++i) {
+			const uint part = min( count, BLOCK_SIZE - start_pos );
+			if (!direct[i] && !write)
+				memcpy( data, bounce + BLOCK_SIZE * j + start_pos, part );
+			if (!direct[i])
+				++j;
 			/* If it did not read til the end of the block it won't be used again. */
 			start_pos = 0;
+			data  += part;
+			count -= part;
 		}
-		PRINT_DEBUG ("Read %d B of data to: %p.\n", copy_count, buffer);
-/*	  for (uint i = 0; i < copy_count; ++i) {
-	    printf("  %p:\"%c\"<%d>  ",
-				buffer + i, ((char*)ADDR_TO_KSEG0((uint)buffer))[i], 
-				((char*)ADDR_TO_KSEG0((uint)buffer))[i]);
-	  };
-	*/
-		count  -= copy_count;
-		target += copy_count;
-		++secno; /* read next sector. */
+		free( bounce );
+
+		if (!success)
+			return false;
+		secno += sectors;
 	}
-	PRINT_DEBUG ("Leaving read to buffer: %p.\n", buffer);
-	return (! (m_registers[STATUS] & ERROR_MASK));
+	return true;
 }
 /*----------------------------------------------------------------------------*/
-void MsimDisk::block()
+bool MsimDisk::dmaAddress(
+	const void* target, IVirtualMemoryMap* vmm, uintptr_t& physical )
 {
-	
-	m_waitingThread = Thread::getCurrent();
-	ASSERT (m_waitingThread);
+	if (ADDR_IN_KSEG0(target)) {
+		physical = ADDR_TO_USEG((uintptr_t)target);
+		return true;
+	}
 
-	m_waitingThread->block();
-	while (pending())
-		m_waitingThread->yield();
+	if (!vmm || !ADDR_IN_USEG((uintptr_t)target))
+		return false;
 
-	//while (pending()) {};
-	//PRINT_DEBUG ("Operation ended: %x.\n", m_registers[STATUS]);
-	ASSERT (! (m_registers[STATUS] & ERROR_MASK));
-	m_registers[STATUS] = DONE_MASK;
-	m_waitingThread = NULL;
+	/* Only writable pages are used, frames of anonymous memory and dirty
+	 * private pages are freed only with their area and the pinned map
+	 * keeps its areas. Clean file pages might be dropped by reclaim while
+	 * the device writes to them. */
+	void* address = const_cast<void*>(target);
+	Processor::PageSize frame_type;
+	bool writable;
+	if (!vmm->translate( address, frame_type, writable ) || !writable)
+		return false;
+
+	/* translate gives the start of the frame, sector must not cross it */
+	const size_t frame_size = Processor::pages[frame_type].size;
+	const size_t in_frame = (uintptr_t)target & (frame_size - 1);
+	if (in_frame + BLOCK_SIZE > frame_size)
+		return false;
+
+	physical = (uintptr_t)address + in_frame;
+	return true;
 }
 /*----------------------------------------------------------------------------*/
-bool MsimDisk::write( void* buffer, uint count, uint block, uint start_pos )
+bool MsimDisk::transfer( DiskRequest& request )
 {
 	InterruptDisabler inter;
 
-	/* not IMPLEMENTED */
-  return false;
+	request.owner = Thread::getCurrent();
+	ASSERT (request.owner);
+
+	m_queue.insert( &request );
+	if (!m_current) {
+		m_current = m_queue.take( m_head );
+		start();
+	}
+
+	/* handleInterrupt() resumes the owner when the last sector is done */
+	while (request.count) {
+		request.owner->block();
+		request.owner->yield();
+	}
+	return !request.failed;
 }
 /*----------------------------------------------------------------------------*/
-void MsimDisk::diskOp( uint block_num, unative_t buffer, OperationMask op)
+void MsimDisk::start()
 {
 	ASSERT (!pending());
-	PRINT_DEBUG ("Started Disk op. buffer %p, sector: %u.\n", buffer, block_num);
-	PRINT_DEBUG ("Locations: %p, %p and %p.\n", &m_registers[DATA], &m_registers[SECTOR], &m_registers[STATUS]);
-	m_registers[DATA]   = buffer;
-	m_registers[SECTOR] = block_num;
-	m_registers[STATUS] = op;
-	PRINT_DEBUG ("Command issued %p(%p) %u.\n", m_registers[DATA], buffer, m_registers[SECTOR]);
-	block();
+	if (!m_current) return;
+
+	PRINT_DEBUG ("Started Disk op. buffer %p, sector: %u.\n",
+		*m_current->addresses, m_current->sector);
+	TRACE( DISK_START, m_current->sector, m_current->write );
+	m_registers[DATA]   = *m_current->addresses;
+	m_registers[SECTOR] = m_current->sector;
+	m_registers[STATUS] = m_current->write ? OP_WRITE : OP_READ;
+	m_head = m_current->sector + 1;
 }
 /*----------------------------------------------------------------------------*/
 void MsimDisk::handleInterrupt()
 {
 	PRINT_DEBUG ("Handling disk interrupt.\n");
 	ASSERT (!pending());
-	ASSERT (m_waitingThread);
+	ASSERT (m_current);
 
-	m_waitingThread->resume();
-	m_waitingThread = NULL;
+	DiskRequest* done = m_current;
+	const bool failed = m_registers[STATUS] & ERROR_MASK;
 	m_registers[STATUS] = DONE_MASK;
+	TRACE( DISK_DONE, done->sector, failed );
+
+	++done->sector;
+	++done->addresses;
+	--done->count;
+	if (failed) {
+		done->failed = true;
+		done->count = 0;
+	}
+
+	/* continue with the same or the next request in the sweep */
+	if (done->count)
+		m_queue.insert( done );
+	else
+		done->owner->resume();
+
+	m_current = m_queue.take( m_head );
+	start();
 }
 /*----------------------------------------------------------------------------*/
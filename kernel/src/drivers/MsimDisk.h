@@ -35,16 +35,20 @@
 #pragma once
 
 #include "devices.h"
-#include "synchronization/Mutex.h"
 #include "DiskDevice.h"
-
-#define BLOCK_SIZE 512
+#include "DiskQueue.h"
 
 class Thread;
+class IVirtualMemoryMap;
 
 /*!
  * @class MsimDisk MsimDisk.h "drivers/MsimDisk.h"
  * @brief Class provides hardware specific access to disk device used by MSIM.
+ *
+ * Callers do not wait for each other, their requests are queued in the
+ * C-LOOK order (see DiskQueue) and the interrupt handler starts the next
+ * sector as soon as the previous one is done, so the device does not idle
+ * until a woken thread gets scheduled.
  */
 class MsimDisk: public DiskDevice
 {
@@ -54,7 +58,7 @@ public:
 	 * @param address Address of the first control register.
 	 */
 	MsimDisk( unative_t* address ):
-		m_registers( address )
+		m_registers( address ), m_current( NULL ), m_head( 0 )
 		{};
 
 	/*!
@@ -66,8 +70,10 @@ public:
 	 * 	the start of the block.
 	 * @return @a True on success, @a false otherwise.
 	 *
-	 * @note: if buffer is accessible to the disk device data are copied directly
-	 * 	otherwise internall driver buffer is used.
+	 * @note: Whole sectors are transferred directly to the buffer if it is
+	 * 	in KSEG0 or in writable user memory of the current address space
+	 * 	(see dmaAddress()), otherwise through a temporary kernel buffer.
+	 * 	The address space is pinned until the transfer ends.
 	 */
 	bool read( void* buffer, uint count, uint block, uint start_pos );
 
@@ -81,7 +87,7 @@ public:
 	 * 	the start of the block.
 	 * @return @a True on success, @a false otherwise.
 	 *
-	 * @note: NOT implemented.
+	 * @note: Sectors that are written only partially are read first.
 	 */
 	bool write( void* buffer, uint count, uint block, uint start_pos );
 
@@ -109,16 +115,51 @@ private:
 		DATA, SECTOR, STATUS, SIZE, LIMIT
 	};
 
+	/*! @brief Maximum number of sectors in one queued request. */
+	static const uint CHUNK_SECTORS = 16;
+
+	/*!
+	 * @brief Transfers data between the disk and the buffer.
+	 * @param data Buffer to fill or to write.
+	 * @param count Number of bytes.
+	 * @param secno Starting sector.
+	 * @param start_pos Offset of the first byte in the starting sector.
+	 * @param write @a True to write to the disk, @a false to read.
+	 * @return @a True on success, @a false otherwise.
+	 */
+	bool access( char* data, uint count, uint secno, uint start_pos, bool write );
+
+	/*!
+	 * @brief Transfers data in chunks of CHUNK_SECTORS, see access().
+	 * @param vmm Pinned address space of @a data, NULL for KSEG0 buffers.
+	 * @note Parameters and return value are the same as of access().
+	 */
+	bool accessChunks( IVirtualMemoryMap* vmm,
+		char* data, uint count, uint secno, uint start_pos, bool write );
+
+	/*!
+	 * @brief Queues the request and waits until it is finished.
+	 * @param request Request to transfer.
+	 * @return @a True on success, @a false on device error.
+	 */
+	bool transfer( DiskRequest& request );
+
 	/*!
-	 * @brief directly accesses device to perform oeration.
-	 * @param block_num NUmber of block to operate on.
-	 * @param buffer Buffer to use for the operation.
-	 * @param op Operation to perform (read/write).
+	 * @brief Issues command for the next sector of the current request.
+	 * @note Interrupts have to be disabled.
 	 */
-	void diskOp( uint block_num, unative_t buffer, OperationMask op );
+	void start();
 
-	/*! @brief Blocks current thread until the operation is finished.	 */
-	void block();
+	/*!
+	 * @brief Finds physical address the device can transfer a sector to/from.
+	 * @param target Virtual address of the sector destination.
+	 * @param vmm Pinned address space of user addresses.
+	 * @param physical Physical address is stored here.
+	 * @return @a True if the whole sector can be transferred directly,
+	 * 	@a false if it has to go through a kernel buffer.
+	 */
+	bool dmaAddress( const void* target, IVirtualMemoryMap* vmm,
+		uintptr_t& physical );
 
 	/*!
 	 * @brief Gets operation status of the device.
@@ -130,12 +171,12 @@ private:
 	/*! @brief Device registers. */
 	volatile unative_t* m_registers;
 
-	/*! @brief Thread that caused the current activity. */
-	Thread* m_waitingThread;
+	/*! @brief Request the device works on, NULL if idle. */
+	DiskRequest* m_current;
+
+	/*! @brief Sector following the last issued one. */
+	uint m_head;
 
-	/*! Internal driver buffer. */
-	char m_buffer[BLOCK_SIZE];
-	
-	/*! Only one Thread can access disk. */
-	Mutex m_guard;
+	/*! @brief Requests waiting for the device. */
+	DiskQueue m_queue;
 };
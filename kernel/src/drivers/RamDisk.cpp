@@ -0,0 +1,91 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Class RamDisk implementation.
+ */
+
+#include "RamDisk.h"
+#include "api.h"
+#include "address.h"
+
+//#define RAM_DISK_DEBUG
+
+#ifndef RAM_DISK_DEBUG
+#define PRINT_DEBUG(...)
+#else
+#define PRINT_DEBUG(ARGS...)\
+  puts("[ RAM DISK DEBUG ]: ");\
+  printf(ARGS);
+#endif
+
+/*! @brief Position and value of the TAR magic in the header. */
+#define TAR_MAGIC_POS 257
+#define TAR_MAGIC "ustar"
+
+RamDisk::RamDisk( uintptr_t start, size_t size ):
+	m_data( (char*)ADDR_TO_KSEG0( start ) ), m_size( size )
+{
+	PRINT_DEBUG ("Created disk of %u B at %p.\n", m_size, m_data);
+}
+/*----------------------------------------------------------------------------*/
+bool RamDisk::hasImage( uintptr_t start )
+{
+	const char* data = (const char*)ADDR_TO_KSEG0( start );
+	const char* magic = TAR_MAGIC;
+	for (uint i = 0; magic[i]; ++i)
+		if (data[TAR_MAGIC_POS + i] != magic[i])
+			return false;
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+char* RamDisk::address( uint count, uint block, uint start_pos )
+{
+	const size_t start = (size_t)block * BLOCK_SIZE + start_pos;
+	if (start > m_size || count > m_size - start)
+		return NULL;
+	return m_data + start;
+}
+/*----------------------------------------------------------------------------*/
+bool RamDisk::read( void* buffer, uint count, uint block, uint start_pos )
+{
+	const char* data = address( count, block, start_pos );
+	PRINT_DEBUG ("Reading %u B from block %u+%u.\n", count, block, start_pos);
+	if (!data)
+		return false;
+	memcpy( buffer, data, count );
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+bool RamDisk::write( void* buffer, uint count, uint block, uint start_pos )
+{
+	char* data = address( count, block, start_pos );
+	PRINT_DEBUG ("Writing %u B to block %u+%u.\n", count, block, start_pos);
+	if (!data)
+		return false;
+	memcpy( data, buffer, count );
+	return true;
+}
@@ -0,0 +1,101 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Class RamDisk declaration.
+ *
+ * RAM disk serves a disk image the simulator loaded into memory at boot
+ * (see msim-ramdisk.conf), transfers are plain copies.
+ */
+
+#pragma once
+
+#include "types.h"
+#include "DiskDevice.h"
+
+/*!
+ * @class RamDisk RamDisk.h "drivers/RamDisk.h"
+ * @brief Disk stored in the physical memory.
+ *
+ * Memory is accessed through KSEG0, it must not be managed by the
+ * FrameAllocator. The disk raises no interrupts and needs no cache.
+ */
+class RamDisk: public DiskDevice
+{
+public:
+	/*!
+	 * @brief Creates disk in the memory.
+	 * @param start Physical address of the image.
+	 * @param size Size of the memory.
+	 */
+	RamDisk( uintptr_t start, size_t size );
+
+	/*!
+	 * @brief Copies data from the image.
+	 * @param buffer Place to store the data.
+	 * @param count Number of bytes to read.
+	 * @param block Starting block.
+	 * @param start_pos Offset of the first byte from the start of the block.
+	 * @return @a True on success, @a false if the data are out of the disk.
+	 */
+	bool read( void* buffer, uint count, uint block, uint start_pos );
+
+	/*!
+	 * @brief Copies data to the image, they are lost on power off.
+	 * @param buffer Data to write.
+	 * @param count Number of bytes to write.
+	 * @param block Starting block.
+	 * @param start_pos Offset of the first byte from the start of the block.
+	 * @return @a True on success, @a false if the data are out of the disk.
+	 */
+	bool write( void* buffer, uint count, uint block, uint start_pos );
+
+	/*! @brief Gets size of the disk. */
+	size_t size() { return m_size; };
+
+	/*! @brief There are no interrupts. */
+	void handleInterrupt() {};
+
+	/*!
+	 * @brief Checks that the memory holds a TAR image.
+	 * @param start Physical address of the image.
+	 * @return @a True if the first block is a TAR header.
+	 */
+	static bool hasImage( uintptr_t start );
+
+private:
+	char* m_data;   /*!< KSEG0 address of the image. */
+	size_t m_size;  /*!< Size of the image.          */
+
+	/*!
+	 * @brief Gets address of the data.
+	 * @param count Number of bytes.
+	 * @param block Starting block.
+	 * @param start_pos Offset of the first byte from the start of the block.
+	 * @return Address of the first byte, NULL if the data are out of the disk.
+	 */
+	char* address( uint count, uint block, uint start_pos );
+};
@@ -0,0 +1,221 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief StripedDisk class implementation.
+ */
+
+#include "StripedDisk.h"
+#include "tools.h"
+#include "InterruptDisabler.h"
+#include "proc/KernelThread.h"
+#include "mem/IVirtualMemoryMap.h"
+
+//#define STRIPED_DISK_DEBUG
+
+#ifndef STRIPED_DISK_DEBUG
+#define PRINT_DEBUG(...)
+#else
+#define PRINT_DEBUG(ARGS...) \
+  printf("[ STRIPED DISK DEBUG ]: "); \
+  printf(ARGS);
+#endif
+
+/*----------------------------------------------------------------------------*/
+StripedDisk::StripedDisk( DiskDevice* disks[], uint count ):
+	m_count( min( count, MAX_DISKS ) )
+{
+	ASSERT (m_count);
+	for (uint i = 0; i < m_count; ++i) {
+		ASSERT (disks[i]);
+		m_disks[i] = disks[i];
+		m_helpers[i].volume = this;
+		m_helpers[i].disk = i;
+	}
+}
+/*----------------------------------------------------------------------------*/
+bool StripedDisk::read( void* buffer, uint count, uint block, uint start_pos )
+{
+	Transfer job;
+	job.buffer   = (char*)buffer;
+	job.count    = count;
+	job.block    = block;
+	job.startPos = start_pos;
+	return transfer( job );
+}
+/*----------------------------------------------------------------------------*/
+bool StripedDisk::write( void* buffer, uint count, uint block, uint start_pos )
+{
+	Transfer job;
+	job.buffer   = (char*)buffer;
+	job.write    = true;
+	job.count    = count;
+	job.block    = block;
+	job.startPos = start_pos;
+	return transfer( job );
+}
+/*----------------------------------------------------------------------------*/
+bool StripedDisk::transfer( Transfer& job )
+{
+	if (!job.count) return true;
+
+	const uint block = job.block;
+
+	/* disks holding the data, the first one is served by the caller */
+	const uint first_stripe = block / STRIPE_BLOCKS;
+	const uint last_stripe =
+		(block + (job.startPos + job.count + BLOCK_SIZE - 1) / BLOCK_SIZE - 1)
+		/ STRIPE_BLOCKS;
+	const uint disks = min( last_stripe - first_stripe + 1, m_count );
+	const uint first = diskOf( first_stripe );
+
+	bool helped[MAX_DISKS] = { false };
+	uint helpers = 0;
+	if (disks > 1) {
+		job.vmm = IVirtualMemoryMap::getCurrent();
+		InterruptDisabler inter;
+		for (uint i = 1; i < disks; ++i) {
+			const uint disk = diskOf( first_stripe + i );
+			if (!startHelper( disk ))
+				continue;
+			m_helpers[disk].jobs.pushBack( &job );
+			m_helpers[disk].pending.up();
+			helped[disk] = true;
+			++helpers;
+		}
+	}
+
+	PRINT_DEBUG ("%s %u B from block %u on %u disks (%u helpers).\n",
+		job.write ? "Writing" : "Reading", job.count, block, disks, helpers);
+
+	bool success = transferParts( job, first );
+	/* parts of disks without helper */
+	for (uint i = 1; i < disks; ++i) {
+		const uint disk = diskOf( first_stripe + i );
+		if (!helped[disk])
+			success = transferParts( job, disk ) && success;
+	}
+
+	if (helpers)
+		job.done.down( helpers );
+	return success && !job.failed;
+}
+/*----------------------------------------------------------------------------*/
+bool StripedDisk::transferParts( const Transfer& job, uint disk )
+{
+	uint done = 0;
+	uint block = job.block;
+	uint offset = job.startPos;
+
+	while (done < job.count) {
+		const uint stripe = block / STRIPE_BLOCKS;
+		const uint next = (stripe + 1) * STRIPE_BLOCKS;
+		const uint bytes =
+			min( job.count - done, (next - block) * BLOCK_SIZE - offset );
+
+		if (diskOf( stripe ) == disk) {
+			const uint disk_block =
+				(stripe / m_count) * STRIPE_BLOCKS + block % STRIPE_BLOCKS;
+			char* data = job.buffer + done;
+			if (!(job.write
+				? m_disks[disk]->write( data, bytes, disk_block, offset )
+				: m_disks[disk]->read( data, bytes, disk_block, offset )))
+				return false;
+		}
+		done  += bytes;
+		block  = next;
+		offset = 0;
+	}
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+bool StripedDisk::startHelper( uint disk )
+{
+	Helper& helper = m_helpers[disk];
+	if (helper.thread)
+		return true;
+
+	thread_t id;
+	helper.thread = KernelThread::create( &id, helperThread, &helper );
+	if (!helper.thread)
+		return false;
+	helper.thread->setVMM( NULL );
+	PRINT_DEBUG ("Started helper %u of disk %u.\n", id, disk);
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+void* StripedDisk::helperThread( void* data )
+{
+	Helper& helper = *(Helper*)data;
+	Thread* thread = Thread::getCurrent();
+
+	while (true) {
+		helper.pending.down();
+
+		Transfer* job;
+		{
+			InterruptDisabler inter;
+			ASSERT (!helper.jobs.empty());
+			job = helper.jobs.getFront();
+			helper.jobs.popFront();
+			/* buffer might be in the user memory of the caller */
+			thread->setVMM( job->vmm );
+			if (job->vmm)
+				job->vmm->switchTo();
+			else
+				IVirtualMemoryMap::switchOff();
+		}
+
+		if (!helper.volume->transferParts( *job, helper.disk ))
+			job->failed = true;
+
+		{
+			InterruptDisabler inter;
+			thread->setVMM( NULL );
+			IVirtualMemoryMap::switchOff();
+			job->done.up();
+		}
+	}
+	return NULL;
+}
+/*----------------------------------------------------------------------------*/
+bool StripedDisk::flush()
+{
+	bool success = true;
+	for (uint i = 0; i < m_count; ++i)
+		success = m_disks[i]->flush() && success;
+	return success;
+}
+/*----------------------------------------------------------------------------*/
+size_t StripedDisk::size()
+{
+	const size_t stripe_size = STRIPE_BLOCKS * BLOCK_SIZE;
+	size_t smallest = m_disks[0]->size();
+	for (uint i = 1; i < m_count; ++i)
+		smallest = min( smallest, m_disks[i]->size() );
+	return (smallest / stripe_size) * stripe_size * m_count;
+}
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,179 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief StripedDisk class declaration.
+ *
+ * Several disks joined into one volume by striping (RAID-0).
+ */
+#pragma once
+
+#include "api.h"
+#include "DiskDevice.h"
+#include "Pointer.h"
+#include "structures/List.h"
+#include "synchronization/Semaphore.h"
+
+class Thread;
+class IVirtualMemoryMap;
+
+/*!
+ * @class StripedDisk StripedDisk.h "drivers/StripedDisk.h"
+ * @brief Volume striped over several disks.
+ *
+ * Blocks are split into stripes of STRIPE_BLOCKS blocks, consecutive
+ * stripes are stored on consecutive disks. Stripe @a s is stored on disk
+ * <tt>s % N</tt> as its stripe <tt>s / N</tt>.
+ *
+ * Transfers spanning several disks are split, the parts stored on other
+ * disks than the first one are handed to helper threads (one per disk),
+ * so all disks transfer data at the same time. Helpers use the address space of
+ * the caller, user buffers are filled directly.
+ */
+class StripedDisk: public DiskDevice
+{
+public:
+	/*! @brief Maximum number of joined disks. */
+	static const uint MAX_DISKS = 4;
+
+	/*! @brief Number of blocks in one stripe (size of a BlockCache line). */
+	static const uint STRIPE_BLOCKS = 16;
+
+	/*!
+	 * @brief Joins the disks into one volume.
+	 * @param disks Disks to join, interrupts are handled by them.
+	 * @param count Number of disks, at most MAX_DISKS.
+	 */
+	StripedDisk( DiskDevice* disks[], uint count );
+
+	/*!
+	 * @brief Reads data from the volume.
+	 * @param buffer Place to store the data.
+	 * @param count Number of bytes to read.
+	 * @param block Starting block.
+	 * @param start_pos Offset of the first requested byte from 
+	 * 	the start of the block.
+	 * @return @a True on success, @a false otherwise.
+	 */
+	bool read( void* buffer, uint count, uint block, uint start_pos );
+
+	/*!
+	 * @brief Writes data to the volume.
+	 * @param buffer Data to write.
+	 * @param count Number of bytes to write.
+	 * @param block Starting block.
+	 * @param start_pos Offset of the first byte from the start of the block.
+	 * @return @a True on success, @a false otherwise.
+	 */
+	bool write( void* buffer, uint count, uint block, uint start_pos );
+
+	/*!
+	 * @brief Flushes all joined disks.
+	 * @return @a True if all disks were flushed.
+	 */
+	bool flush();
+
+	/*!
+	 * @brief Gets size of the volume.
+	 * @return Number of whole stripes all disks can store, in bytes.
+	 */
+	size_t size();
+
+	/*! @brief Interrupts are handled by the joined disks. */
+	void handleInterrupt() {};
+
+private:
+	/*! @brief Transfer split among the disks. */
+	struct Transfer {
+		char* buffer;                    /*!< Data buffer.               */
+		bool write;                      /*!< Write instead of read.     */
+		uint count;                      /*!< Number of bytes.           */
+		uint block;                      /*!< First block of the volume. */
+		uint startPos;                   /*!< Offset in the first block. */
+		Pointer<IVirtualMemoryMap> vmm;  /*!< Address space of the caller.*/
+		Semaphore done;                  /*!< Finished parts.            */
+		bool failed;                     /*!< Some disk failed.          */
+
+		/*! @brief Nothing is done yet. */
+		Transfer(): write( false ), done( 0 ), failed( false ) {};
+	};
+
+	/*! @brief Helper transferring data of one disk. */
+	struct Helper {
+		StripedDisk* volume;             /*!< Volume of the disk.        */
+		uint disk;                       /*!< Served disk.               */
+		Thread* thread;                  /*!< The thread, NULL if none.  */
+		List<Transfer*> jobs;            /*!< Transfers waiting for it.  */
+		Semaphore pending;               /*!< Number of waiting jobs.    */
+
+		/*! @brief No thread yet. */
+		Helper(): thread( NULL ), pending( 0 ) {};
+	};
+
+	DiskDevice* m_disks[MAX_DISKS];     /*!< Joined disks.              */
+	uint m_count;                       /*!< Number of joined disks.    */
+	Helper m_helpers[MAX_DISKS];        /*!< Helpers of the disks.      */
+
+	/*!
+	 * @brief Splits the transfer among the disks and waits for it.
+	 * @param job The transfer.
+	 * @return @a True on success, @a false otherwise.
+	 */
+	bool transfer( Transfer& job );
+
+	/*!
+	 * @brief Transfers all parts of the transfer stored on the disk.
+	 * @param job The transfer.
+	 * @param disk The disk.
+	 * @return @a True on success, @a false otherwise.
+	 */
+	bool transferParts( const Transfer& job, uint disk );
+
+	/*!
+	 * @brief Gets disk storing the stripe.
+	 * @param stripe Number of the stripe in the volume.
+	 */
+	inline uint diskOf( uint stripe ) const { return stripe % m_count; };
+
+	/*!
+	 * @brief Starts the helper thread of the disk.
+	 * @param disk The disk.
+	 * @return @a True if the helper runs.
+	 */
+	bool startHelper( uint disk );
+
+	/*!
+	 * @brief Helper thread entry point.
+	 * @param helper Helper structure of the thread.
+	 */
+	static void* helperThread( void* helper );
+
+	/*! @brief No copying. */
+	StripedDisk( const StripedDisk& );
+
+	/*! @brief No assigning. */
+	StripedDisk& operator = ( const StripedDisk& );
+};
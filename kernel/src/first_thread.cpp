@@ -34,44 +34,20 @@
 #include "proc/UserThread.h"
 #include "Kernel.h"
 #include "tarfs/TarFS.h"
+#include "tarfs/FileEntry.h"
 #include "proc/Process.h"
 
-size_t gets_feedback( char* buffer, size_t buffer_size )
-{
-	uint ptr = 0;
-	char c;
-	while (( (c = getc()) != '\n') && ptr < (buffer_size) - 1 )
-	{
-		if (c == 127) {
-			if (ptr > 0) {
-				--ptr;
-				puts( "\b \b" );
-			}
-		} else {
-			buffer[ptr++] = c;
-			putc( c );
-		}
-	}
-	buffer[ptr] = '\0';
-	return ptr;
-}
 Process* exec( const char* file, TarFS* fs )
 {
-	Entry* proc_file = fs->rootDir()->subEntry( file );
+	Entry* proc_file = fs->getFile( file );
 	
-	if (!proc_file) {
+	if (!proc_file || !proc_file->fileEntry() || !proc_file->open( OPEN_R )) {
 		printf("Open file failed.\n");
 		return NULL;
 	}
 
-	const size_t file_size = proc_file->seek( POS_END, 0 );
-	proc_file->seek( POS_START, 0 );
-
-	char* image = (char*)malloc(file_size);
-	proc_file->read( image, file_size );
-
-	Process* main_proc = Process::create( image, file_size );
-	free(image);
+	Process* main_proc = Process::create( proc_file->fileEntry() );
+	proc_file->close();
 
 	if (!main_proc) {
 		printf( "Failed to launch process: %s.\n", file );
@@ -86,7 +62,10 @@ void* first_thread(void* data)
 		thread_t thr;
 		Thread* thread = KernelThread::create( &thr, (void*(*)(void*))run_test );
 		Thread::getCurrent()->join( thread, NULL );
-		KERNEL.halt();
+		#ifndef USER_TEST
+			/* the user test runs next if there is one (make bench) */
+			KERNEL.halt();
+		#endif
 	#endif
 	
 	#ifdef USER_TEST
@@ -129,8 +108,7 @@ void* first_thread(void* data)
 
 		printf("\n or type halt to shut down.\n# ");
 
-		size_t read = gets_feedback(buffer, BUFFER_SIZE);
-		putc('\n');
+		ssize_t read = gets(buffer, BUFFER_SIZE);
 		if (read == 0){
 			printf("Read error halting...\n");
 			KERNEL.halt();
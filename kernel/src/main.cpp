@@ -53,6 +53,12 @@ void wrapped_general( Processor::Context* registers )
 	KERNEL.exception( registers );
 }
 
+/*! entry point for syscalls */
+unative_t wrapped_syscall( unative_t* params, uint number )
+{
+	return KERNEL.syscall( params, number );
+}
+
 /*! TLB miss handler */
 void wrapped_tlbrefill()
 {
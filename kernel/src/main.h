@@ -34,4 +34,5 @@
 
 extern "C" void wrapped_start(void) __attribute__ ((noreturn));
 extern "C" void wrapped_general(Processor::Context* registers);
+extern "C" unative_t wrapped_syscall(unative_t* params, uint number);
 extern "C" void wrapped_tlbrefill(void);
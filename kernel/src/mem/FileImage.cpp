@@ -0,0 +1,174 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief FileImage class implementation.
+ */
+
+#include "FileImage.h"
+#include "api.h"
+#include "address.h"
+#include "tools.h"
+#include "InterruptDisabler.h"
+#include "mem/Memory.h"
+#include "mem/FileMapping.h"
+#include "mem/FrameAllocator.h"
+#include "tarfs/FileEntry.h"
+
+//#define FILE_IMAGE_DEBUG
+
+#ifndef FILE_IMAGE_DEBUG
+#define PRINT_DEBUG(...)
+#else
+#define PRINT_DEBUG(ARGS...) \
+  printf("[ FILE IMAGE DEBUG ]: "); \
+  printf(ARGS);
+#endif
+
+using namespace Processor;
+
+Pointer<FileImage> FileImage::get( FileEntry* file )
+{
+	ASSERT (file);
+	InterruptDisabler inter;
+
+	for (List<FileImage*>::Iterator it = images().begin();
+		it != images().end(); ++it) {
+		if ((*it)->m_file == file)
+			return Pointer<FileImage>( *it );
+	}
+
+	const size_t frame_size = Memory::frameSize( PAGE_MIN );
+	const uint count = roundUp( file->size(), frame_size ) / frame_size;
+	Page* pages = (Page*)malloc( count * sizeof(Page) );
+	if (count && !pages) return Pointer<FileImage>();
+
+	if (!file->open( OPEN_R )) {
+		free( pages );
+		return Pointer<FileImage>();
+	}
+
+	FileImage* image = new FileImage( file, count, pages );
+	if (!image) {
+		file->close();
+		free( pages );
+	}
+	PRINT_DEBUG ("Created image %p of file %p (%u pages).\n", image, file, count);
+	return Pointer<FileImage>( image );
+}
+/*----------------------------------------------------------------------------*/
+uint FileImage::reclaim( uint count )
+{
+	InterruptDisabler inter;
+
+	uint freed = 0;
+	for (List<FileImage*>::Iterator it = images().begin();
+		it != images().end() && freed < count; ++it) {
+		freed += (*it)->drop( count - freed );
+	}
+	return freed;
+}
+/*----------------------------------------------------------------------------*/
+FileImage::FileImage( FileEntry* file, uint page_count, Page* pages ):
+	m_file( file ), m_pageCount( page_count ), m_pages( pages )
+{
+	for (uint i = 0; i < m_pageCount; ++i) {
+		m_pages[i].frame = NULL;
+		m_pages[i].users = 0;
+	}
+
+	append( &images() );
+}
+/*----------------------------------------------------------------------------*/
+void* FileImage::acquire( uint page )
+{
+	if (page >= m_pageCount)
+		return NULL;
+
+	if (!m_pages[page].frame) {
+		void* frame = FileMapping::allocateFrame();
+		if (!frame)
+			return NULL;
+
+		/* the last page is zeroed past the end of the file */
+		const size_t frame_size = Memory::frameSize( PAGE_MIN );
+		const size_t position = page * frame_size;
+		const size_t count = min<size_t>( frame_size, m_file->size() - position );
+
+		char* target = (char*)ADDR_TO_KSEG0( (uintptr_t)frame );
+		if (m_file->readAt( target, count, position ) != (ssize_t)count) {
+			PRINT_DEBUG ("Failed to read page %u of image %p.\n", page, this);
+			FrameAllocator::instance().frameFree( frame, 1, PAGE_MIN );
+			return NULL;
+		}
+		for (size_t i = count; i < frame_size; ++i)
+			target[i] = 0;
+
+		/* someone else might have loaded the page while we were reading */
+		if (m_pages[page].frame) {
+			FrameAllocator::instance().frameFree( frame, 1, PAGE_MIN );
+		} else {
+			PRINT_DEBUG ("Loaded page %u of image %p to %p.\n", page, this, frame);
+			m_pages[page].frame = frame;
+		}
+	}
+
+	++m_pages[page].users;
+	return m_pages[page].frame;
+}
+/*----------------------------------------------------------------------------*/
+void FileImage::release( uint page )
+{
+	ASSERT (page < m_pageCount);
+	ASSERT (m_pages[page].frame);
+	ASSERT (m_pages[page].users);
+	--m_pages[page].users;
+}
+/*----------------------------------------------------------------------------*/
+uint FileImage::drop( uint count )
+{
+	uint freed = 0;
+	for (uint i = 0; i < m_pageCount && freed < count; ++i) {
+		if (!m_pages[i].frame || m_pages[i].users) continue;
+		FrameAllocator::instance().frameFree( m_pages[i].frame, 1, PAGE_MIN );
+		m_pages[i].frame = NULL;
+		++freed;
+	}
+	return freed;
+}
+/*----------------------------------------------------------------------------*/
+FileImage::~FileImage()
+{
+	InterruptDisabler inter;
+	PRINT_DEBUG ("Destroying image %p of file %p.\n", this, m_file);
+	for (uint i = 0; i < m_pageCount; ++i) {
+		ASSERT (!m_pages[i].users);
+		if (m_pages[i].frame)
+			FrameAllocator::instance().frameFree( m_pages[i].frame, 1, PAGE_MIN );
+	}
+	free( m_pages );
+	m_file->close();
+}
@@ -0,0 +1,126 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief FileImage class declaration.
+ *
+ * File image caches pages of an executable file that are the same in all
+ * processes running it, so they can share the physical frames.
+ */
+#pragma once
+
+#include "types.h"
+#include "Object.h"
+#include "Pointer.h"
+#include "structures/ListInsertable.h"
+
+class FileEntry;
+
+/*!
+ * @class FileImage FileImage.h "mem/FileImage.h"
+ * @brief Shared read only pages of one file.
+ *
+ * There is at most one image of every FileEntry. Image is reference counted,
+ * every file mapping of the file holds one reference. Pages are read into
+ * frames when first requested and stay in memory as long as the image
+ * exists, users of the page are counted. Frames that nobody uses are
+ * returned when memory runs out (see reclaim()), all the frames are freed
+ * when the last mapping of the file is destroyed (last process running
+ * the binary exits).
+ *
+ * Frames are never written, private mappings copy the page before
+ * the first write.
+ */
+class FileImage: public Object, public ListInsertable<FileImage>
+{
+public:
+	/*!
+	 * @brief Finds image of the file or creates a new one.
+	 * @param file The file.
+	 * @return Pointer to the image, NULL on failure.
+	 */
+	static Pointer<FileImage> get( FileEntry* file );
+
+	/*!
+	 * @brief Frees frames of images that are not used by any mapping.
+	 * @param count Maximum number of frames to free.
+	 * @return Number of frames returned to the frame allocator.
+	 */
+	static uint reclaim( uint count );
+
+	/*!
+	 * @brief Gets frame containing the page of the file.
+	 * @param page Index of the page in the file.
+	 * @return Physical address of the frame, NULL on failure.
+	 *
+	 * Page is read if it is not in memory, this might block the caller.
+	 * Every successful call has to be paired with release().
+	 */
+	void* acquire( uint page );
+
+	/*!
+	 * @brief Returns page acquired before.
+	 * @param page Index of the page in the file.
+	 */
+	void release( uint page );
+
+	/*! @brief Gets the file. */
+	inline FileEntry* file() const { return m_file; };
+
+	/*! @brief Frees all frames and closes the file. */
+	~FileImage();
+
+private:
+	/*! @brief Cached page of the file. */
+	struct Page {
+		void* frame;              /*!< Physical address, NULL if absent.  */
+		uint users;               /*!< Number of mappings using the page. */
+	};
+
+	FileEntry* m_file;        /*!< Cached file.                       */
+	uint m_pageCount;         /*!< Number of pages of the file.       */
+	Page* m_pages;            /*!< Page states.                       */
+
+	/*! @brief Initializes members. */
+	FileImage( FileEntry* file, uint page_count, Page* pages );
+
+	/*!
+	 * @brief Frees frames that are not used by any mapping.
+	 * @param count Maximum number of frames to free.
+	 * @return Number of released frames.
+	 */
+	uint drop( uint count );
+
+	/*! @brief No copying. */
+	FileImage( const FileImage& );
+
+	/*! @brief No assigning. */
+	FileImage& operator = ( const FileImage& );
+
+	/*! @brief All existing images, used by get() and reclaim(). */
+	static List<FileImage*>& images()
+		{ static List<FileImage*> list; return list; }
+};
@@ -0,0 +1,335 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief FileMapping class implementation.
+ */
+
+#include "FileMapping.h"
+#include "api.h"
+#include "address.h"
+#include "tools.h"
+#include "InterruptDisabler.h"
+#include "mem/Memory.h"
+#include "mem/TLB.h"
+#include "mem/FrameAllocator.h"
+#include "tarfs/FileEntry.h"
+#include "drivers/BlockCache.h"
+
+//#define FILE_MAPPING_DEBUG
+
+#ifndef FILE_MAPPING_DEBUG
+#define PRINT_DEBUG(...)
+#else
+#define PRINT_DEBUG(ARGS...) \
+  printf("[ FILE MAPPING DEBUG ]: "); \
+  printf(ARGS);
+#endif
+
+using namespace Processor;
+
+FileMapping* FileMapping::create( FileEntry* file, size_t offset,
+	size_t length, size_t size, bool writable )
+{
+	if (size == 0 || !Memory::isAligned( size, PAGE_MIN ) || length > size)
+		return NULL;
+	if (length && (!file || offset > file->size() || length > file->size() - offset))
+		return NULL;
+
+	const uint count = size / Memory::frameSize( PAGE_MIN );
+	Page* pages = (Page*)malloc( count * sizeof(Page) );
+	if (!pages) return NULL;
+
+	/* mapping with no file content (bss) needs no file */
+	Pointer<FileImage> image;
+	if (length && !(image = FileImage::get( file ))) {
+		free( pages );
+		return NULL;
+	}
+
+	FileMapping* mapping =
+		new FileMapping( image, offset, length, size, writable, pages );
+	if (!mapping)
+		free( pages );
+	return mapping;
+}
+/*----------------------------------------------------------------------------*/
+uint FileMapping::reclaim( uint count )
+{
+	InterruptDisabler inter;
+
+	/* nothing maps these, dropping them costs no TLB entries */
+	uint freed = FileImage::reclaim( count );
+	if (freed < count)
+		freed += BlockCache::reclaim( count - freed );
+
+	/* the first round clears marks of referenced pages, the second one
+	 * drops them if they were not mapped again */
+	for (uint round = 0; round < 2 && freed < count; ++round) {
+		for (int i = mappings().size(); i > 0 && freed < count; --i) {
+			FileMapping* mapping = mappings().getFront();
+			freed += mapping->evict( count - freed );
+			/* hand stays at the mapping if it had enough pages */
+			if (freed < count)
+				mapping->append( &mappings() );
+		}
+		/* shared pages released by the mappings */
+		if (freed < count)
+			freed += FileImage::reclaim( count - freed );
+	}
+
+	PRINT_DEBUG ("Reclaimed %u of %u frames.\n", freed, count);
+	return freed;
+}
+/*----------------------------------------------------------------------------*/
+void* FileMapping::allocateFrame()
+{
+	void* frame = NULL;
+	if (FrameAllocator::instance().allocateAtKseg0( &frame, 1, PAGE_MIN ) == 1)
+		return frame;
+
+	frame = NULL;
+	if (!reclaim( 1 ) ||
+		FrameAllocator::instance().allocateAtKseg0( &frame, 1, PAGE_MIN ) != 1)
+	{
+		PRINT_DEBUG ("No frame for file data.\n");
+		return NULL;
+	}
+	return frame;
+}
+/*----------------------------------------------------------------------------*/
+FileMapping::FileMapping( Pointer<FileImage> image, size_t offset,
+	size_t length, size_t size, bool writable, Page* pages ):
+	m_image( image ), m_offset( offset ), m_length( length ), m_size( size ),
+	m_writable( writable ), m_pageCount( size / Memory::frameSize( PAGE_MIN ) ),
+	m_pages( pages ), m_hand( 0 )
+{
+	for (uint i = 0; i < m_pageCount; ++i) {
+		m_pages[i].frame      = NULL;
+		m_pages[i].dirty      = false;
+		m_pages[i].shared     = false;
+		m_pages[i].referenced = false;
+	}
+
+	InterruptDisabler inter;
+	append( &mappings() );
+}
+/*----------------------------------------------------------------------------*/
+bool FileMapping::translate( size_t offset, void*& address,
+	Processor::PageSize& frameType, bool& writable )
+{
+	const uint page = offset / Memory::frameSize( PAGE_MIN );
+	if (page >= m_pageCount)
+		return false;
+
+	if (!m_pages[page].frame && !load( page ))
+		return false;
+
+	address   = m_pages[page].frame;
+	frameType = PAGE_MIN;
+	writable  = m_pages[page].dirty;
+	m_pages[page].referenced = true;
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+bool FileMapping::write(
+	size_t offset, void*& address, Processor::PageSize& frameType )
+{
+	if (!m_writable)
+		return false;
+
+	const uint page = offset / Memory::frameSize( PAGE_MIN );
+
+	/* second attempt is made if copying needed reclaim */
+	for (uint attempt = 0; attempt < 2; ++attempt) {
+		bool writable;
+		if (!translate( offset, address, frameType, writable ))
+			return false;
+
+		InterruptDisabler inter;
+		if (m_pages[page].shared) {
+			/* no reclaim here, it could take the page we copy */
+			void* frame = NULL;
+			if (FrameAllocator::instance().allocateAtKseg0( &frame, 1, PAGE_MIN ) != 1) {
+				if (!reclaim( 1 )) return false;
+				continue;
+			}
+
+			const uint32_t* src = (uint32_t*)ADDR_TO_KSEG0( (uintptr_t)m_pages[page].frame );
+			uint32_t* dst = (uint32_t*)ADDR_TO_KSEG0( (uintptr_t)frame );
+			for (uint i = 0; i < Memory::frameSize( PAGE_MIN ) / sizeof(uint32_t); ++i)
+				dst[i] = src[i];
+
+			PRINT_DEBUG ("Page %u of mapping %p copied from %p to %p.\n",
+				page, this, m_pages[page].frame, frame);
+			/* read only entries of the shared frame must not stay */
+			TLB::instance().clearFrame( (uintptr_t)m_pages[page].frame );
+			m_image->release( imagePage( page ) );
+			m_pages[page].frame  = frame;
+			m_pages[page].shared = false;
+			address = frame;
+		}
+
+		PRINT_DEBUG ("Page %u of mapping %p is dirty.\n", page, this);
+		m_pages[page].dirty = true;
+		return true;
+	}
+	return false;
+}
+/*----------------------------------------------------------------------------*/
+inline uint FileMapping::imagePage( uint page ) const
+{
+	return (m_offset + page * Memory::frameSize( PAGE_MIN ))
+		/ Memory::frameSize( PAGE_MIN );
+}
+/*----------------------------------------------------------------------------*/
+bool FileMapping::shareable( uint page ) const
+{
+	const size_t frame_size = Memory::frameSize( PAGE_MIN );
+	const size_t position = page * frame_size;
+
+	/* image pages are aligned in the file */
+	if (!m_image || !Memory::isAligned( m_offset, PAGE_MIN ) || position >= m_length)
+		return false;
+
+	/* either the whole page is used or the rest of the file is zeroed */
+	return (position + frame_size <= m_length) ||
+		(m_offset + m_length == m_image->file()->size());
+}
+/*----------------------------------------------------------------------------*/
+bool FileMapping::load( uint page )
+{
+	if (shareable( page )) {
+		void* frame = m_image->acquire( imagePage( page ) );
+		if (!frame)
+			return false;
+
+		/* someone else might have loaded the page while we were reading */
+		if (m_pages[page].frame) {
+			m_image->release( imagePage( page ) );
+			return true;
+		}
+
+		PRINT_DEBUG ("Shared page %u of mapping %p at %p.\n", page, this, frame);
+		m_pages[page].frame  = frame;
+		m_pages[page].shared = true;
+		return true;
+	}
+
+	const size_t frame_size = Memory::frameSize( PAGE_MIN );
+
+	void* frame = allocateFrame();
+	if (!frame) {
+		PRINT_DEBUG ("No frame for page %u of mapping %p.\n", page, this);
+		return false;
+	}
+
+	/* read what belongs to the file, the rest of the page is zeroed */
+	const size_t position = page * frame_size;
+	const size_t count = (position < m_length)
+		? min<size_t>( frame_size, m_length - position ) : 0;
+
+	char* target = (char*)ADDR_TO_KSEG0( (uintptr_t)frame );
+	if (count && m_image->file()->readAt( target, count, m_offset + position )
+		!= (ssize_t)count) {
+		PRINT_DEBUG ("Failed to read page %u of mapping %p.\n", page, this);
+		FrameAllocator::instance().frameFree( frame, 1, PAGE_MIN );
+		return false;
+	}
+	for (size_t i = count; i < frame_size; ++i)
+		target[i] = 0;
+
+	/* someone else might have loaded the page while we were reading */
+	if (m_pages[page].frame) {
+		FrameAllocator::instance().frameFree( frame, 1, PAGE_MIN );
+		return true;
+	}
+
+	PRINT_DEBUG ("Loaded page %u of mapping %p to %p.\n", page, this, frame);
+	m_pages[page].frame = frame;
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+void FileMapping::release( uint page )
+{
+	ASSERT (m_pages[page].frame);
+	if (m_pages[page].shared)
+		m_image->release( imagePage( page ) );
+	else
+		FrameAllocator::instance().frameFree( m_pages[page].frame, 1, PAGE_MIN );
+
+	m_pages[page].frame      = NULL;
+	m_pages[page].dirty      = false;
+	m_pages[page].shared     = false;
+	m_pages[page].referenced = false;
+}
+/*----------------------------------------------------------------------------*/
+uint FileMapping::evict( uint count )
+{
+	uint freed = 0;
+	for (uint step = 0; step < m_pageCount && freed < count; ++step) {
+		const uint i = m_hand;
+		m_hand = (m_hand + 1) % m_pageCount;
+
+		if (!m_pages[i].frame || m_pages[i].dirty) continue;
+		if (m_pages[i].referenced) {
+			/* the next access refills the entry and marks the page again */
+			m_pages[i].referenced = false;
+			TLB::instance().clearFrame( (uintptr_t)m_pages[i].frame );
+			continue;
+		}
+
+		PRINT_DEBUG ("Evicting page %u of mapping %p.\n", i, this);
+		TLB::instance().clearFrame( (uintptr_t)m_pages[i].frame );
+		/* shared frames are counted when the image drops them */
+		if (!m_pages[i].shared) ++freed;
+		release( i );
+	}
+	return freed;
+}
+/*----------------------------------------------------------------------------*/
+void FileMapping::usage( size_t& own, size_t& shared ) const
+{
+	InterruptDisabler inter;
+	const size_t frame_size = Memory::frameSize( PAGE_MIN );
+	for (uint i = 0; i < m_pageCount; ++i) {
+		if (!m_pages[i].frame) continue;
+		if (m_pages[i].shared)
+			shared += frame_size;
+		else
+			own += frame_size;
+	}
+}
+/*----------------------------------------------------------------------------*/
+FileMapping::~FileMapping()
+{
+	InterruptDisabler inter;
+	for (uint i = 0; i < m_pageCount; ++i) {
+		if (m_pages[i].frame)
+			release( i );
+	}
+	free( m_pages );
+}
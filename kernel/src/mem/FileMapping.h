@@ -0,0 +1,214 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief FileMapping class declaration.
+ *
+ * File mapping backs virtual memory area with the content of a file instead
+ * of anonymous frames.
+ */
+#pragma once
+
+#include "types.h"
+#include "Pointer.h"
+#include "drivers/Processor.h"
+#include "structures/ListInsertable.h"
+#include "mem/FileImage.h"
+
+class FileEntry;
+
+/*!
+ * @class FileMapping FileMapping.h "mem/FileMapping.h"
+ * @brief Lazily loaded view of a file.
+ *
+ * Mapping covers @a size bytes, the first @a length of them are read from
+ * the file starting at any file offset, the rest is zero filled (BSS).
+ * Nothing is read when the mapping is created, frames are allocated and
+ * filled when the page is touched for the first time (TLB refill).
+ *
+ * Pages that hold nothing but the file content come from the FileImage of
+ * the file, so all mappings of the same file share their frames. Only pages
+ * cut by @a length (e.g. the end of the data segment) get frames of their own.
+ *
+ * Pages are mapped read only until they are written. Writing to a page of
+ * a private mapping makes the page dirty (see write()), shared page is
+ * copied first. Writing to a read only mapping fails. Clean pages can be
+ * dropped and read again whenever memory runs out, see reclaim().
+ * Pages are marked referenced when they are mapped to the TLB, reclaim()
+ * sweeps the mappings in clock order and drops pages that were not
+ * referenced since the previous sweep.
+ */
+class FileMapping: public ListInsertable<FileMapping>
+{
+public:
+	/*!
+	 * @brief Creates mapping of the file.
+	 * @param file File to map, it is opened for the lifetime of the mapping.
+	 * 	Might be NULL if @a length is 0.
+	 * @param offset Offset of the first mapped byte in the file.
+	 * @param length Number of bytes read from the file.
+	 * @param size Size of the mapping, aligned to the PAGE_MIN frames.
+	 * @param writable Private writable mapping if @a true,
+	 * 	read only mapping otherwise.
+	 * @return Pointer to the new mapping, NULL on failure.
+	 */
+	static FileMapping* create( FileEntry* file, size_t offset, size_t length,
+		size_t size, bool writable );
+
+	/*!
+	 * @brief Returns frames holding file data to the frame allocator.
+	 * @param count Number of frames needed.
+	 * @return Number of frames returned to the frame allocator.
+	 *
+	 * Unused pages of file images and unused disk cache lines (least
+	 * recently used first) go first as nothing maps them. Clean resident
+	 * pages of the mappings follow in clock order, their TLB entries are
+	 * cleared. Reclaiming stops as soon as @a count frames are free.
+	 */
+	static uint reclaim( uint count = 1 );
+
+	/*!
+	 * @brief Allocates frame reachable through KSEG0.
+	 * @return Physical address of the frame, NULL if there is none.
+	 *
+	 * Clean file pages are reclaimed if there is no free frame.
+	 */
+	static void* allocateFrame();
+
+	/*!
+	 * @brief Translates offset within the mapping to the physical address.
+	 * @param offset Offset from the start of the mapping.
+	 * @param address Physical address of the frame is stored here.
+	 * @param frameType Size of the frame is stored here.
+	 * @param writable Whether the page might be written without
+	 * 	calling write() first.
+	 * @return @a true on success, @a false if the offset is outside
+	 * 	the mapping or the page could not be loaded.
+	 *
+	 * Page that is not resident is loaded, this might block the caller.
+	 */
+	bool translate( size_t offset, void*& address,
+		Processor::PageSize& frameType, bool& writable );
+
+	/*!
+	 * @brief Prepares the page for writing.
+	 * @param offset Offset from the start of the mapping.
+	 * @param address Physical address of the frame is stored here.
+	 * @param frameType Size of the frame is stored here.
+	 * @return @a true if the page can be written, @a false if the mapping is
+	 * 	read only or the page could not be loaded.
+	 *
+	 * Page shared with other mappings is replaced by a private copy.
+	 * Page is marked dirty, it won't be dropped any more.
+	 */
+	bool write( size_t offset, void*& address, Processor::PageSize& frameType );
+
+	/*!
+	 * @brief Drops clean resident pages that were not referenced
+	 * 	since the clock hand passed them last time.
+	 * @param count Number of frames needed.
+	 * @return Number of released frames, shared pages are returned
+	 * 	to the file image and not counted.
+	 *
+	 * Hand moves at most once around the mapping, referenced pages lose
+	 * the mark and get a second chance. TLB entries of the dropped pages
+	 * are cleared.
+	 */
+	uint evict( uint count );
+
+	/*!
+	 * @brief Counts resident pages.
+	 * @param own Bytes of frames of this mapping are added here.
+	 * @param shared Bytes of frames borrowed from the file image are
+	 * 	added here, other mappings of the file might use them too.
+	 */
+	void usage( size_t& own, size_t& shared ) const;
+
+	/*! @brief Releases all frames and closes the file. */
+	~FileMapping();
+
+private:
+	/*! @brief State of one page of the mapping. */
+	struct Page {
+		void* frame;              /*!< Physical address, NULL if absent.  */
+		bool dirty;               /*!< Page was written.                  */
+		bool shared;              /*!< Frame belongs to the file image.   */
+		bool referenced;          /*!< Mapped since the hand passed.      */
+	};
+
+	Pointer<FileImage> m_image; /*!< Image of the mapped file.        */
+	size_t m_offset;          /*!< File offset of the first page.     */
+	size_t m_length;          /*!< Number of bytes read from the file.*/
+	size_t m_size;            /*!< Size of the mapping.               */
+	bool m_writable;          /*!< Private writable mapping.          */
+	uint m_pageCount;         /*!< Number of pages in the mapping.    */
+	Page* m_pages;            /*!< Page states.                       */
+	uint m_hand;              /*!< Next page checked by evict().      */
+
+	/*!
+	 * @brief Makes the page resident.
+	 * @param page Index of the page.
+	 * @return @a true on success, @a false otherwise.
+	 *
+	 * Page is taken from the file image if possible, it is read into
+	 * a new frame otherwise.
+	 */
+	bool load( uint page );
+
+	/*!
+	 * @brief Checks whether the page can be shared with other mappings.
+	 * @param page Index of the page.
+	 * @return @a true if the page is a whole page of the file (or its last
+	 * 	part followed by zeros), @a false otherwise.
+	 */
+	bool shareable( uint page ) const;
+
+	/*!
+	 * @brief Gets index of the page in the file image.
+	 * @param page Index of the page in the mapping.
+	 */
+	inline uint imagePage( uint page ) const;
+
+	/*!
+	 * @brief Returns the frame of the resident page.
+	 * @param page Index of the page.
+	 */
+	void release( uint page );
+
+	/*! @brief Initializes members. */
+	FileMapping( Pointer<FileImage> image, size_t offset, size_t length,
+		size_t size, bool writable, Page* pages );
+
+	/*! @brief No copying. */
+	FileMapping( const FileMapping& );
+
+	/*! @brief No assigning. */
+	FileMapping& operator = ( const FileMapping& );
+
+	/*! @brief All existing mappings, used by reclaim(). */
+	static List<FileMapping*>& mappings()
+		{ static List<FileMapping*> list; return list; }
+};
@@ -36,6 +36,7 @@
 #include "structures/Bitset.h"
 #include "cpp.h"
 #include "InterruptDisabler.h"
+#include "Tracer.h"
 
 //#define FRALLOC_DEBUG
 
@@ -252,15 +253,18 @@ uint FrameAllocator::frameAlloc( void** address, const size_t count,
 		return 0;
 	}
 
-	if (requestAtKseg(flags))
-		return allocateAtKseg0( address, count, frame );
-
-	if (requestOutOfKseg(flags))
-		return allocateAtKuseg( address, count, frame );
+	uint allocated = 0;
+	if (requestAtKseg(flags)) {
+		allocated = allocateAtKseg0( address, count, frame );
+	} else if (requestOutOfKseg(flags)) {
+		allocated = allocateAtKuseg( address, count, frame );
+	} else {
+		ASSERT(requestUser(flags));
+		allocated = allocateAtAddress(*address, count, frame );
+	}
 
-	// else 
-	ASSERT(requestUser(flags));
-	return allocateAtAddress(*address, count, frame );
+	TRACE( FRAME_ALLOC, (uintptr_t)*address, allocated * frameSize(frame) );
+	return allocated;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -656,6 +660,7 @@ bool FrameAllocator::frameFree(
 	}
 
 	PRINT_DEBUG("Request to free %u frames of size %u, starting from address %x\n", count, frameSize(frame), address);
+	TRACE( FRAME_FREE, (uintptr_t)address, count * frameSize(frame) );
 
 	uintptr_t addr = (uintptr_t)address;
 	
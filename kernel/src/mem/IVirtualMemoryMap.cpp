@@ -36,6 +36,7 @@
 #include "mem/TLB.h"
 #include "InterruptDisabler.h"
 #include "tools.h"
+#include "address.h"
 #include "drivers/Processor.h"
 
 //#define IVMM_DEBUG
@@ -56,6 +57,57 @@ void IVirtualMemoryMap::freed()
 		TLB::instance().clearAsid( m_asid );
 }
 /*----------------------------------------------------------------------------*/
+void IVirtualMemoryMap::unpin()
+{
+	InterruptDisabler inter;
+	ASSERT (m_pins);
+	if (--m_pins == 0)
+		m_unpinned.fire();
+}
+/*----------------------------------------------------------------------------*/
+void IVirtualMemoryMap::waitUnpinned()
+{
+	InterruptDisabler inter;
+	while (m_pins) {
+		PRINT_DEBUG ("Waiting for %u transfers of VMM %p.\n", m_pins, this);
+		m_unpinned.wait();
+	}
+}
+/*----------------------------------------------------------------------------*/
+bool IVirtualMemoryMap::writable(const void* address, size_t size)
+{
+	const uintptr_t start = (uintptr_t)address;
+	/* the whole range has to be in USEG, start + size must not wrap */
+	if (!ADDR_IN_USEG(start) || size > ADDR_PREFIX_KSEG0 - start)
+		return false;
+
+	size_t done = 0;
+	while (done < size) {
+		size_t left;
+		if (!kernelAddress( (const void*)(start + done), left ))
+			return false;
+		done += left;
+	}
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+void* IVirtualMemoryMap::kernelAddress(const void* address, size_t& frame_end)
+{
+	if (!ADDR_IN_USEG((uintptr_t)address))
+		return NULL;
+
+	void* frame = const_cast<void*>(address);
+	Processor::PageSize frame_type;
+	if (!write( frame, frame_type ))
+		return NULL;
+
+	/* write gives the start of the frame */
+	const size_t frame_size = Processor::pages[frame_type].size;
+	const size_t in_frame = (uintptr_t)address & (frame_size - 1);
+	frame_end = frame_size - in_frame;
+	return (void*)ADDR_TO_KSEG0( (uintptr_t)frame + in_frame );
+}
+/*----------------------------------------------------------------------------*/
 void IVirtualMemoryMap::switchTo()
 {
 	if (!m_asid) {
@@ -35,6 +35,9 @@
 #include "Object.h"
 #include "Pointer.h"
 #include "drivers/Processor.h"
+#include "synchronization/Event.h"
+
+class FileMapping;
 
 /*! @class IVirtualMemoryMap IVirtualMemoryMap.h "mem/IVirtualMemoryMap.h"
  *
@@ -48,7 +51,7 @@
 class IVirtualMemoryMap: public Object
 {
 public:
-	inline IVirtualMemoryMap():m_asid( 0 ){};
+	inline IVirtualMemoryMap():m_asid( 0 ), m_pins( 0 ){};
 
 	static inline Pointer<IVirtualMemoryMap>& getCurrent()
 		{ static Pointer<IVirtualMemoryMap> current; return current; }
@@ -92,6 +95,18 @@ public:
 	 */
 	virtual int allocate(void** from, size_t size, unsigned int flags) = 0;
 
+	/*! @brief Interface for creating file backed virtual memory area.
+	 * @param from pointer to the location where the starting address
+	 * 	of the new VMA is stored.
+	 * @param size requested size of the VMA.
+	 * @param flags VF_VA_USER to place the VMA at @a *from.
+	 * @param mapping file mapping backing the VMA, VMA takes the ownership.
+	 * @return EOK on success, respective error code otherwise.
+	 * @note See documentation of child class, that implements this function.
+	 */
+	virtual int map(void** from, size_t size, unsigned int flags,
+		FileMapping* mapping) = 0;
+
 	/*! @brief Destroys VMA.
 	 * @param from The first byte of the VMA.
 	 * @return EOK on succes, respective error code otherwise.
@@ -135,10 +150,58 @@ public:
 	 * @param address Virtual address to translate, physical adress is returned
 	 * 	in this param as well.
 	 * @param frame_size size of the frame physical address resides in.
+	 * @param writable whether the page might be written without
+	 * 	calling write() first.
 	 * @return @a true on success, @a false otherwise.
 	 * @note See documentation of child class, that implements this function.
 	 */
-	virtual bool translate(void*& address, Processor::PageSize& frame_size) = 0;
+	virtual bool translate(void*& address, Processor::PageSize& frame_size,
+		bool& writable) = 0;
+
+	/*! @brief Prepares page for writing (handles TLB modified exception).
+	 * @param address Written virtual address, physical address of the page
+	 * 	is returned in this param as well.
+	 * @param frame_size size of the frame physical address resides in.
+	 * @return @a true if the page can be written, @a false otherwise.
+	 * @note See documentation of child class, that implements this function.
+	 */
+	virtual bool write(void*& address, Processor::PageSize& frame_size) = 0;
+
+	/*! @brief Gets memory used by the map.
+	 * @param areas Number of virtual memory areas is stored here.
+	 * @param resident Size of frames used only by this map is stored here.
+	 * @param shared Size of file image frames mapped is stored here.
+	 * @note See documentation of child class, that implements this function.
+	 */
+	virtual void usage(uint& areas, size_t& resident, size_t& shared) = 0;
+	/*! @brief Prepares user memory for writing by the kernel.
+	 * @param address The first byte of the range.
+	 * @param size Size of the range.
+	 * @return @a true if every page of the range is mapped and writable.
+	 *
+	 * Private file pages are copied and marked dirty, so reclaim keeps
+	 * them until their area is freed.
+	 */
+	bool writable(const void* address, size_t size);
+	/*! @brief Gets kernel (KSEG0) address of a writable user byte.
+	 * @param address Virtual address in this map.
+	 * @param frame_end Bytes left in the frame from @a address are stored here.
+	 * @return Kernel address, NULL if @a address can not be written.
+	 *
+	 * The result is valid while the map is pinned.
+	 */
+	void* kernelAddress(const void* address, size_t& frame_end);
+
+	/*! @brief Keeps frames of all areas in place.
+	 *
+	 * Used while a device transfers data to or from the frames directly.
+	 * free() and resize() of a pinned map wait until it is unpinned, the
+	 * pinning side keeps a Pointer to the map so it outlives its process.
+	 */
+	inline void pin() { ++m_pins; }
+
+	/*! @brief Releases one pin, wakes those waiting for the last one. */
+	void unpin();
 
 	/*! @brief Returns used ASID. */
 	virtual ~IVirtualMemoryMap();
@@ -147,6 +210,11 @@ protected:
 	/*! @brief Makes sure that the free area is no longer accessible. */
 	void freed();
 
+	/*! @brief Blocks the caller until the map is not pinned. */
+	void waitUnpinned();
+
 private:
 	byte m_asid; /*!< ASID used by this map, no other map can have same ASID. */
+	uint m_pins;       /*!< Number of transfers using the frames. */
+	Event m_unpinned;  /*!< Fired when the last pin is released.  */
 };
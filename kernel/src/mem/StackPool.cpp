@@ -0,0 +1,134 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief StackPool class implementation.
+ */
+
+#include "StackPool.h"
+#include "api.h"
+#include "InterruptDisabler.h"
+
+//#define STACK_POOL_DEBUG
+
+#ifndef STACK_POOL_DEBUG
+#define PRINT_DEBUG(...)
+#else
+#define PRINT_DEBUG(ARGS...) \
+  printf("[ STACK POOL DEBUG ]: "); \
+  printf(ARGS);
+#endif
+
+StackPool::StackPool(): m_hits( 0 ), m_misses( 0 )
+{
+	for (uint i = 0; i < BIN_COUNT; ++i) {
+		m_bins[i].size  = 0;
+		m_bins[i].count = 0;
+		m_bins[i].first = NULL;
+	}
+}
+/*----------------------------------------------------------------------------*/
+StackPool::Bin* StackPool::bin( size_t size, bool create )
+{
+	Bin* empty = NULL;
+	for (uint i = 0; i < BIN_COUNT; ++i) {
+		if (m_bins[i].size == size)
+			return &m_bins[i];
+		if (!empty && m_bins[i].count == 0)
+			empty = &m_bins[i];
+	}
+
+	if (create && empty) {
+		PRINT_DEBUG ("Reusing bin %p for stacks of size %u.\n", empty, size);
+		empty->size = size;
+		return empty;
+	}
+	return NULL;
+}
+/*----------------------------------------------------------------------------*/
+void* StackPool::get( size_t size )
+{
+	ASSERT (size >= sizeof(FreeStack));
+
+	{
+		InterruptDisabler inter;
+
+		Bin* my_bin = bin( size, false );
+		if (my_bin && my_bin->count) {
+			FreeStack* stack = my_bin->first;
+			my_bin->first = stack->next;
+			--my_bin->count;
+			++m_hits;
+			PRINT_DEBUG ("Recycled stack %p of size %u.\n", stack, size);
+			return stack;
+		}
+		++m_misses;
+	}
+
+	void* stack = malloc( size );
+	if (!stack) {
+		PRINT_DEBUG ("Stack allocation failed, releasing cached stacks.\n");
+		clear();
+		stack = malloc( size );
+	}
+	return stack;
+}
+/*----------------------------------------------------------------------------*/
+void StackPool::put( void* stack, size_t size )
+{
+	if (!stack) return;
+
+	{
+		InterruptDisabler inter;
+
+		Bin* my_bin = bin( size, true );
+		if (my_bin && my_bin->count < BIN_CAPACITY) {
+			FreeStack* free_stack = (FreeStack*)stack;
+			free_stack->next = my_bin->first;
+			my_bin->first = free_stack;
+			++my_bin->count;
+			PRINT_DEBUG ("Stored stack %p of size %u (%u in bin).\n",
+				stack, size, my_bin->count);
+			return;
+		}
+	}
+
+	free( stack );
+}
+/*----------------------------------------------------------------------------*/
+void StackPool::clear()
+{
+	InterruptDisabler inter;
+
+	for (uint i = 0; i < BIN_COUNT; ++i) {
+		while (m_bins[i].first) {
+			FreeStack* stack = m_bins[i].first;
+			m_bins[i].first = stack->next;
+			free( stack );
+		}
+		m_bins[i].count = 0;
+	}
+}
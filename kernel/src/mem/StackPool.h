@@ -0,0 +1,122 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief StackPool class declaration.
+ *
+ * Kernel stacks of the threads that have ended are kept here instead of being
+ * returned to the kernel heap, next thread of the same stack size gets
+ * them back without going through malloc.
+ */
+#pragma once
+
+#include "Singleton.h"
+#include "types.h"
+
+/*!
+ * @class StackPool StackPool.h "mem/StackPool.h"
+ * @brief Recycles kernel thread stacks.
+ *
+ * Pool keeps up to BIN_CAPACITY free stacks for each of BIN_COUNT different
+ * stack sizes. Free stacks are chained through their first word so no
+ * additional memory is needed to store them. Stacks that do not fit into
+ * any bin are returned to the kernel heap.
+ */
+class StackPool: public Singleton<StackPool>
+{
+public:
+	/*! @brief Number of different stack sizes cached. */
+	static const uint BIN_COUNT = 4;
+
+	/*! @brief Maximum number of free stacks kept for one stack size. */
+	static const uint BIN_CAPACITY = 16;
+
+	/*!
+	 * @brief Gets stack of the requested size.
+	 * @param size Size of the stack.
+	 * @return Pointer to the start (lowest address) of the stack,
+	 * 	NULL on failure.
+	 *
+	 * Recycled stack is used if there is one, new stack is allocated on
+	 * the kernel heap otherwise. If the allocation fails all cached stacks
+	 * are returned to the heap and allocation is retried.
+	 */
+	void* get( size_t size );
+
+	/*!
+	 * @brief Returns no longer used stack.
+	 * @param stack Stack previously acquired by get().
+	 * @param size Size of the stack (the same as was used in get()).
+	 */
+	void put( void* stack, size_t size );
+
+	/*! @brief Returns all cached stacks to the kernel heap. */
+	void clear();
+
+	/*! @brief Gets number of requests satisfied by recycled stacks. */
+	inline uint hits() const { return m_hits; };
+
+	/*! @brief Gets number of requests that needed to allocate new stack. */
+	inline uint misses() const { return m_misses; };
+
+private:
+	/*! @brief Free stack header, stored in the first bytes of the stack. */
+	struct FreeStack {
+		FreeStack* next;          /*!< Next free stack of the same size. */
+	};
+
+	/*! @brief Free stacks of one size. */
+	struct Bin {
+		size_t size;              /*!< Size of the stacks in this bin.  */
+		uint count;               /*!< Number of stored stacks.         */
+		FreeStack* first;         /*!< The first stored stack.          */
+	};
+
+	Bin m_bins[BIN_COUNT];      /*!< Bins for different stack sizes.  */
+	uint m_hits;                /*!< Number of recycled stacks given. */
+	uint m_misses;              /*!< Number of newly allocated stacks.*/
+
+	/*!
+	 * @brief Finds bin storing stacks of the given size.
+	 * @param size Size of the stack.
+	 * @param create Use free bin if there is no bin for this size.
+	 * @return Pointer to the bin, NULL if there is no such bin.
+	 */
+	Bin* bin( size_t size, bool create );
+
+	/*! @brief Creates empty pool. */
+	StackPool();
+
+	/*! @brief No copying. */
+	StackPool( const StackPool& );
+
+	/*! @brief No assigning. */
+	StackPool& operator = ( const StackPool& );
+
+	friend class Singleton<StackPool>;
+};
+
+#define STACK_POOL StackPool::instance()
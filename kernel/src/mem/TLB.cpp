@@ -35,6 +35,7 @@
 #include "InterruptDisabler.h"
 #include "tools.h"
 #include "mem/IVirtualMemoryMap.h"
+#include "Tracer.h"
 
 //#define TLB_DEBUG
 
@@ -135,6 +136,30 @@ void TLB::clearAsid( const byte asid )
 	reg_write_entryhi( old_asid );
 }
 /*----------------------------------------------------------------------------*/
+void TLB::clearFrame( const uintptr_t frame )
+{
+	InterruptDisabler interrupts;
+
+	using namespace Processor;
+
+	const unative_t pfn = addrToEntryLo( frame, PAGE_MIN, 0, false ) & PFN_ADDR_MASK;
+	const native_t old_asid = reg_read_entryhi();
+
+	for (uint i = reg_read_wired(); i < ENTRY_COUNT; ++i) {
+		reg_write_index( i );
+		TLB_read();
+		if ((reg_read_entrylo0() & PFN_ADDR_MASK) == pfn) {
+			PRINT_DEBUG ("Clearing frame %p from entry %u.\n", frame, i);
+			reg_write_entryhi ( 0xff );
+			reg_write_pagemask( pages[PAGE_MIN].mask );
+			reg_write_entrylo0( 0 );
+			reg_write_entrylo1( 0 );
+			TLB_write_index();
+		}
+	}
+	reg_write_entryhi( old_asid );
+}
+/*----------------------------------------------------------------------------*/
 void TLB::switchAsid( byte asid )
 {
 	PRINT_DEBUG ("Switching ASID to %u.\n", asid);
@@ -193,30 +218,57 @@ void TLB::returnAsid( const byte asid )
 	m_asidMap[asid] = NULL;
 }
 /*----------------------------------------------------------------------------*/
-bool  TLB::handleException( Processor::Context* registers )
+bool TLB::handleException( Processor::Context* registers )
 {
-	ASSERT (!"Should never happen.\n");
-	return false;
+	using namespace Processor;
+	ASSERT (get_exccode( registers->cause ) == CAUSE_EXCCODE_MOD);
+
+	Pointer<IVirtualMemoryMap> vmm = IVirtualMemoryMap::getCurrent();
+	if (!vmm || vmm->asid() == BAD_ASID)
+		return false;
+
+	const uintptr_t bad_addr = registers->badva;
+	void* phys_addr = (void*)bad_addr;
+	PageSize page_size;
+
+	const bool success = vmm->write( phys_addr, page_size );
+	PRINT_DEBUG ("Write to virtual address %p ASID: %u %s.\n",
+		bad_addr, vmm->asid(), success ? "allowed" : "denied");
+	TRACE( TLB_MODIFIED, bad_addr, vmm->asid() );
+	if (!success)
+		return false;
+
+	setMapping( bad_addr, (uintptr_t)phys_addr, page_size, vmm->asid(), true );
+	return true;
 }
 /*----------------------------------------------------------------------------*/
 void TLB::setMapping(
 	const uintptr_t virtual_address, const uintptr_t physical_address,
-	const Processor::PageSize page_size, const byte asid
+	const Processor::PageSize page_size, const byte asid, const bool writable
 	) 
 {
 	using namespace Processor;
 
+	InterruptDisabler interrupts;
+
 	const byte old_asid = reg_read_entryhi();
 
 	reg_write_pagemask( pages[page_size].mask << PAGE_MASK_SHIFT );
 	reg_write_entryhi (addrToEntryHi( virtual_address, page_size, asid ));
 
-	const byte flags = ENTRY_LO_VALID_MASK | ENTRY_LO_DIRTY_MASK;
+	/* read only page has to be replaced once it is written */
+	TLB_probe();
+	const bool present = !(reg_read_index() & PROBE_FAILURE);
+
+	const byte flags = ENTRY_LO_VALID_MASK | (writable ? ENTRY_LO_DIRTY_MASK : 0);
 
 	reg_write_entrylo0( addrToEntryLo( physical_address, page_size, flags, false ) );
 	reg_write_entrylo1( addrToEntryLo( physical_address, page_size, flags, true ) );
 
-	TLB_write_random();
+	if (present)
+		TLB_write_index();
+	else
+		TLB_write_random();
 
 	reg_write_entryhi( old_asid );
 }
@@ -234,6 +286,7 @@ bool TLB::refill( Pointer<IVirtualMemoryMap> vmm, native_t bad_addr )
 	if (asid == BAD_ASID) return false;
 
 	PRINT_DEBUG ("Refilling virtual address %p ASID: %u.\n", bad_addr, asid);
+	TRACE( TLB_REFILL, bad_addr, asid );
 	
 	void* phys_addr = (void*)bad_addr;
 	Processor::PageSize page_size;
@@ -241,7 +294,8 @@ bool TLB::refill( Pointer<IVirtualMemoryMap> vmm, native_t bad_addr )
 	const unative_t translate_start = Processor::reg_read_count();
 #endif
 
-	bool success = vmm->translate( phys_addr, page_size );
+	bool writable = true;
+	bool success = vmm->translate( phys_addr, page_size, writable );
 
 #ifdef TLB_DEBUG
 	const unative_t translate_end = Processor::reg_read_count();
@@ -257,7 +311,7 @@ bool TLB::refill( Pointer<IVirtualMemoryMap> vmm, native_t bad_addr )
 	const unative_t map_start = Processor::reg_read_count();
 #endif
 
-	setMapping((uintptr_t)bad_addr, (uintptr_t)phys_addr, page_size, asid);
+	setMapping((uintptr_t)bad_addr, (uintptr_t)phys_addr, page_size, asid, writable);
 #ifdef TLB_DEBUG
 	const unative_t map_end = Processor::reg_read_count();
 	PRINT_DEBUG ("Mapping took: %u.\n",
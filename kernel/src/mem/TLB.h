@@ -61,6 +61,14 @@ public:
 	/*! @brief Prepares the TLB, by @a flushing it. */
 	TLB();
 
+	/*! @brief Handles TLB modification exception.
+	 *
+	 * Store to a page mapped read only asks the memory map to prepare
+	 * the page for writing (private file mappings), the entry is replaced
+	 * with a writable one on success.
+	 * @param registers Context of the faulting thread.
+	 * @return @a true if the page is writable now, @a false otherwise.
+	 */
 	bool handleException( Processor::Context* registers );
 
 	/*! @brief Uses input memory map and address to insert its translation.
@@ -84,10 +92,14 @@ public:
 	 * 	the destination.
 	 * @param page_size Use page of this size.
 	 * @param asid Create entry using this ASID.
+	 * @param writable Page is mapped read only if @a false.
+	 *
+	 * Existing entry for the page is replaced.
 	 */
 	void setMapping(
 		const uintptr_t virtual_address, const uintptr_t physical_address, 
-		const Processor::PageSize page_size, const byte asid
+		const Processor::PageSize page_size, const byte asid,
+		const bool writable = true
 	);
 
 	/*!
@@ -103,6 +115,12 @@ public:
 	 */
 	void clearAsid( const byte asid );
 
+	/*!
+	 * @brief Clears all entries mapping the PAGE_MIN frame, in any ASID.
+	 * @param frame Physical address of the frame.
+	 */
+	void clearFrame( const uintptr_t frame );
+
 	/*! 
 	 * @brief Gets free ASID to use.
 	 * @return Free ASID.
@@ -140,6 +140,10 @@ int VirtualMemory::allocate(void** from, size_t size, unsigned int flags)
 			*from, size);
 		// on error free the allocated memory and return
 		vma.free();
+		// try again if there were some frames used by file mappings
+		if (FileMapping::reclaim(size / Memory::frameSize(PAGE_MIN)) != 0) {
+			return allocate(from, size, flags);
+		}
 		return ENOMEM;
 	}
 
@@ -153,8 +157,53 @@ int VirtualMemory::allocate(void** from, size_t size, unsigned int flags)
 
 /* --------------------------------------------------------------------- */
 
+int VirtualMemory::map(void** from, size_t size, unsigned int flags,
+	FileMapping* mapping)
+{
+	// check if size is aligned and not zero
+	if (!Memory::isAligned(size, PAGE_MIN) || (size == 0) || (mapping == NULL)) {
+		PRINT_DEBUG("Size %u is 0 or is not aligned to frame size %x.\n",
+			size, Memory::frameSize(PAGE_MIN));
+		return EINVAL;
+	}
+
+	if (VF_VIRT_ADDR(flags) == VF_VA_USER) {
+		// user defined address has to be aligned and free
+		if (!Memory::isAligned((size_t)*from, PAGE_MIN) || !isFree(*from, size)) {
+			PRINT_DEBUG("Address %p with size %x is not aligned or not free.\n",
+				*from, size);
+			return EINVAL;
+		}
+	} else {
+		// mappings are always placed in the user segment
+		*from = Memory::getAddressInSegment(VF_AT_KUSEG);
+		if (m_virtualMemoryMap.count() != 0) {
+			getFreeAddress(*from, size, PAGE_MIN);
+		}
+	}
+
+	if ((Memory::getSegment(*from) != VF_AT_KUSEG) || !Memory::checkSegment(*from, size)) {
+		PRINT_DEBUG("No space for mapping of size %x.\n", size);
+		return (VF_VIRT_ADDR(flags) == VF_VA_USER) ? EINVAL : ENOMEM;
+	}
+
+	VirtualMemoryArea vma(*from, size);
+	vma.map(mapping);
+
+	PRINT_DEBUG("Adding file mapped VMA at %p with size %x to the virtual memory map (%u).\n",
+		*from, size, m_virtualMemoryMap.count());
+	m_virtualMemoryMap.insert(vma);
+
+	return EOK;
+}
+
+/* --------------------------------------------------------------------- */
+
 int VirtualMemory::free(const void* from)
 {
+	// devices might be transferring data to the frames
+	waitUnpinned();
+
 	// search for the address and get the VMA
 	const VirtualMemoryMapEntry* entry = m_virtualMemoryMap.findItem(
 		VirtualMemoryMapEntry(VirtualMemoryArea(from)));
@@ -187,6 +236,9 @@ int VirtualMemory::resize(const void* from, const size_t size)
 		return EINVAL;
 	}
 
+	// devices might be transferring data to the frames
+	waitUnpinned();
+
 	// search for the address and get the VMA
 	const VirtualMemoryMapEntry* entry =
 		m_virtualMemoryMap.findItem(VirtualMemoryArea(from));
@@ -197,6 +249,12 @@ int VirtualMemory::resize(const void* from, const size_t size)
 		return EINVAL;
 	}
 
+	// file mappings have fixed size
+	if (entry->data().mapped()) {
+		PRINT_DEBUG("Area %p is file mapped and can't be resized.\n", from);
+		return EINVAL;
+	}
+
 	// actual size of the selected VMA
 	const size_t actualSize = const_cast<VirtualMemoryArea&>(entry->data()).size();
 
@@ -330,6 +388,12 @@ int VirtualMemory::merge(const void* area1, const void* area2)
 		return EINVAL;
 	}
 
+	// file mappings can't be merged
+	if (entry1->data().mapped() || entry2->data().mapped()) {
+		PRINT_DEBUG("Area %p or %p is file mapped.\n", area1, area2);
+		return EINVAL;
+	}
+
 	if (area2 == (void *)((size_t)area1 + entry1->data().size())) {
 		// on the first area call merge
 		const_cast<VirtualMemoryArea&>(entry1->data()).merge(
@@ -374,6 +438,12 @@ int VirtualMemory::split(const void* from, const void* split)
 		return EINVAL;
 	}
 
+	// file mappings can't be split
+	if (entry->data().mapped()) {
+		PRINT_DEBUG("Area %p is file mapped and can't be split.\n", from);
+		return EINVAL;
+	}
+
 	size_t size = entry->data().size();
 
 	// check if split is inside the selected VMA
@@ -401,7 +471,8 @@ int VirtualMemory::split(const void* from, const void* split)
 
 /* --------------------------------------------------------------------- */
 
-bool VirtualMemory::translate(void*& address, Processor::PageSize& frameSize)
+bool VirtualMemory::translate(void*& address, Processor::PageSize& frameSize,
+	bool& writable)
 {
 	PRINT_TLB_DEBUG("Virtual memory map tree size %u, TLB is looking for %p.\n",
 		m_virtualMemoryMap.count(), address);
@@ -421,7 +492,23 @@ bool VirtualMemory::translate(void*& address, Processor::PageSize& frameSize)
 	//if (address == (void*)0xc01a4000) msim_stop();
 
 	// find the address translation on the found VMA
-	return entry->data().find(address, frameSize);
+	return entry->data().find(address, frameSize, writable);
+}
+
+/* --------------------------------------------------------------------- */
+
+bool VirtualMemory::write(void*& address, Processor::PageSize& frameSize)
+{
+	// search for the address and get the VMA
+	const VirtualMemoryMapEntry* entry =
+		m_virtualMemoryMap.findItem( VirtualMemoryArea(address) );
+
+	if (entry == NULL) {
+		PRINT_TLB_DEBUG("Written address %p is not in the tree.\n", address);
+		return false;
+	}
+
+	return entry->data().write(address, frameSize);
 }
 
 /* --------------------------------------------------------------------- */
@@ -568,6 +655,20 @@ void VirtualMemory::dump()
 
 /* --------------------------------------------------------------------- */
 
+void VirtualMemory::usage(uint& areas, size_t& resident, size_t& shared)
+{
+	areas = 0;
+	resident = 0;
+	shared = 0;
+	for (VirtualMemoryMapEntry *x = m_virtualMemoryMap.min(); x != NULL;
+	    x = (VirtualMemoryMapEntry *)x->next()) {
+		++areas;
+		x->data().usage(resident, shared);
+	}
+}
+
+/* --------------------------------------------------------------------- */
+
 VirtualMemory::~VirtualMemory()
 {
 	PRINT_DEBUG("Destroying memory map.\n");
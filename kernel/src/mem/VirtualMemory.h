@@ -73,6 +73,20 @@ public:
 	 */
 	int allocate(void** from, size_t size, unsigned int flags);
 
+	/**
+	 * Create a file backed virtual memory area in the user segment.
+	 * Frames are not allocated, the file mapping loads pages on demand.
+	 *
+	 * @param[in,out] from Optionally (if VF_VA_USER flag set) it is the user defined
+	 *   address of the new VMA. As output parameter it says the address where
+	 *   the new VMA starts (if successful).
+	 * @param[in] size Requested size of the new VMA.
+	 * @param[in] flags Only VF_VA_USER/VF_VA_AUTO is used, the segment is always KUSEG.
+	 * @param[in] mapping File mapping backing the VMA, freed with the VMA.
+	 * @return EOK, ENOMEM or EINVAL
+	 */
+	int map(void** from, size_t size, unsigned int flags, FileMapping* mapping);
+
 	/**
 	 * Free one virtual memory area at the given address.
 	 *
@@ -128,7 +142,28 @@ public:
 	 *   physical block (what mask will be required for the physical address in TLB).
 	 * @return Whether the translation was successful.
 	 */
-	bool translate(void*& address, Processor::PageSize& frameSize);
+	bool translate(void*& address, Processor::PageSize& frameSize, bool& writable);
+
+	/**
+	 * Prepare the page at the virtual address for writing.
+	 *
+	 * @param[in,out] address As input parameter the written virtual address and
+	 *   as output the physical address of the page (only if successful).
+	 * @param[out] frameSize Output parameter, the page size of the physical block.
+	 * @return Whether the page can be written.
+	 */
+	bool write(void*& address, Processor::PageSize& frameSize);
+
+	/**
+	 * Count areas of the map and the memory backing them. Only resident
+	 * pages of file mapped areas are counted, frames of file images are
+	 * reported separately as other maps might use them too.
+	 *
+	 * @param[out] areas Number of virtual memory areas.
+	 * @param[out] resident Bytes of anonymous areas and private file pages.
+	 * @param[out] shared Bytes of file image frames mapped.
+	 */
+	void usage(uint& areas, size_t& resident, size_t& shared);
 
 	/**
 	 * Dump the tree of VMAs. This dump is called always when TLB asks
@@ -73,8 +73,8 @@ void VirtualMemoryArea::address(const void* newAddress)
 	m_address = newAddress;
 
 	// if the new address is aligned only to smaller page size, all subareas
-	// need to be crashed to smaller pieces
-	if (newPS < oldPS) {
+	// need to be crashed to smaller pieces (file mappings use PAGE_MIN only)
+	if ((newPS < oldPS) && (m_subAreas != NULL)) {
 		// get the first subarea (expect there is at least one)
 		VirtualMemorySubareaIterator subarea = m_subAreas->begin();
 		do {
@@ -255,9 +255,24 @@ int VirtualMemoryArea::allocateAtKUSeg(const void* virtualAddress, const size_t
 
 /* --------------------------------------------------------------------- */
 
+void VirtualMemoryArea::map(FileMapping* mapping)
+{
+	ASSERT(m_subAreas == NULL);
+	m_mapping = mapping;
+}
+
+/* --------------------------------------------------------------------- */
+
 void VirtualMemoryArea::free()
 {
 	PRINT_DEBUG("Freeing Area====");
+	if (m_mapping != NULL) {
+		// frames are owned by the mapping
+		delete m_mapping;
+		m_mapping = NULL;
+		m_size    = 0;
+		m_address = NULL;
+	}
 	if (m_subAreas != NULL) {
 		VirtualMemorySubarea* s = NULL;
 		while (m_subAreas->size() != 0) {
@@ -380,17 +395,29 @@ VirtualMemoryArea VirtualMemoryArea::split(const void* split)
 
 /* --------------------------------------------------------------------- */
 
-bool VirtualMemoryArea::find(void*& address, Processor::PageSize& frameType) const
+bool VirtualMemoryArea::find(void*& address, Processor::PageSize& frameType,
+	bool& writable) const
 {
+	/* Skip searching if it is not in my range. */
+	if (address < m_address || address >= (void*)((uintptr_t)m_address + m_size))
+		return false;
+
+	if (m_mapping != NULL) {
+		PRINT_TLB_DEBUG("Searching address %p in file mapped VMA %p (size %x).\n",
+			address, m_address, m_size);
+		// page is loaded from the file if it is not resident
+		return m_mapping->translate(
+			(size_t)address - (size_t)m_address, address, frameType, writable);
+	}
+
 	if (m_subAreas == NULL) return false;
 
+	// anonymous memory is always writable
+	writable = true;
+
 	PRINT_TLB_DEBUG("Searching address %p in VMA %p (size %x with %u subareas).\n",
 		address, m_address, m_size, m_subAreas->size());
 
-	/* Skip searching if it is not in my range. */
-	if (address < m_address || address >= (void*)((uintptr_t)m_address + m_size))
-		return false;
-
 	// virtualAddress we are searching
 	const void *va = address;
 	// virtual start and end addresses of the subarea
@@ -422,6 +449,35 @@ bool VirtualMemoryArea::find(void*& address, Processor::PageSize& frameType) con
 
 /* --------------------------------------------------------------------- */
 
+bool VirtualMemoryArea::write(void*& address, Processor::PageSize& frameType) const
+{
+	if (m_mapping == NULL) {
+		bool writable;
+		return find(address, frameType, writable);
+	}
+
+	/* Skip searching if it is not in my range. */
+	if (address < m_address || address >= (void*)((uintptr_t)m_address + m_size))
+		return false;
+
+	PRINT_TLB_DEBUG("Writing address %p in file mapped VMA %p (size %x).\n",
+		address, m_address, m_size);
+	return m_mapping->write(
+		(size_t)address - (size_t)m_address, address, frameType);
+}
+
+/* --------------------------------------------------------------------- */
+
+void VirtualMemoryArea::usage(size_t& own, size_t& shared) const
+{
+	if (m_mapping != NULL)
+		m_mapping->usage(own, shared);
+	else
+		own += m_size;
+}
+
+/* --------------------------------------------------------------------- */
+
 bool VirtualMemoryArea::operator== (const VirtualMemoryArea& other) const
 {
 	PRINT_OP_DEBUG("Comparing (==) %p (size %x) and %p (size %x).\n",
@@ -37,6 +37,7 @@
 
 #include "mem/FrameAllocator.h"
 #include "mem/VirtualMemorySubarea.h"
+#include "mem/FileMapping.h"
 #include "drivers/Processor.h"
 
 typedef List<VirtualMemorySubarea *> VirtualMemorySubareaContainer;
@@ -59,7 +60,7 @@ public:
 	 * @param size Size of the VMA.
 	 */
 	VirtualMemoryArea(const void* address, const size_t size = 0)
-		: m_address(address), m_size(size), m_subAreas(NULL)
+		: m_address(address), m_size(size), m_subAreas(NULL), m_mapping(NULL)
 	{}
 
 	/**
@@ -112,6 +113,19 @@ public:
 	 */
 	int allocate(const unsigned int flags);
 
+	/**
+	 * Back the VMA with the file mapping instead of allocated frames.
+	 *
+	 * @param mapping File mapping, VMA takes the ownership of it.
+	 */
+	void map(FileMapping* mapping);
+
+	/**
+	 * Check whether the VMA is backed by a file mapping.
+	 * @return Whether the VMA is file backed.
+	 */
+	inline bool mapped() const;
+
 	/**
 	 * Free the VMA.
 	 */
@@ -123,9 +137,30 @@ public:
 	 * @param address The virtual address to be searched for, output is
 	 *   the found physical address (in/out parameter).
 	 * @param frameType Output parameter for the frame size of the found block.
+	 * @param writable Output parameter, whether the page can be written
+	 *   without calling write() first.
 	 * @return Whether the address was found.
 	 */
-	bool find(void*& address, Processor::PageSize& frameType) const;
+	bool find(void*& address, Processor::PageSize& frameType, bool& writable) const;
+
+	/**
+	 * Prepare the page containing the given address for writing.
+	 *
+	 * @param address The virtual address to be written, output is
+	 *   the physical address of the page (in/out parameter).
+	 * @param frameType Output parameter for the frame size of the page.
+	 * @return Whether the page can be written.
+	 */
+	bool write(void*& address, Processor::PageSize& frameType) const;
+
+	/**
+	 * Count the memory backing the VMA.
+	 *
+	 * @param own Bytes of frames used only by this VMA are added here
+	 *   (whole anonymous VMA, private pages of the file mapping).
+	 * @param shared Bytes of file image frames mapped by the VMA are added here.
+	 */
+	void usage(size_t& own, size_t& shared) const;
 
 	/**
 	 * Operator equals is used to compare elements in the splay tree.
@@ -178,6 +213,9 @@ private:
 	/** Subarea container. */
 	VirtualMemorySubareaContainer* m_subAreas;
 
+	/** File mapping backing the VMA (if it is file backed). */
+	FileMapping* m_mapping;
+
 };
 
 /* --------------------------------------------------------------------- */
@@ -194,3 +232,9 @@ inline size_t VirtualMemoryArea::size() const
 	return m_size;
 }
 
+/* --------------------------------------------------------------------- */
+
+inline bool VirtualMemoryArea::mapped() const
+{
+	return m_mapping != NULL;
+}
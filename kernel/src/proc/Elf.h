@@ -0,0 +1,105 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief ELF32 structures.
+ *
+ * Only the parts needed to load statically linked executables are
+ * declared, see the System V ABI (MIPS supplement) for the rest.
+ */
+#pragma once
+
+#include "types.h"
+
+namespace Elf
+{
+
+typedef uint32_t Addr;   /*!< Unsigned program address. */
+typedef uint32_t Off;    /*!< Unsigned file offset.     */
+typedef uint16_t Half;   /*!< Unsigned medium integer.  */
+typedef uint32_t Word;   /*!< Unsigned integer.         */
+
+/*! @brief Size of the identification part of the header. */
+static const uint IDENT_SIZE = 16;
+
+/*! @brief Indices into the identification part of the header. */
+enum Ident {
+	ID_MAG0 = 0, ID_MAG1, ID_MAG2, ID_MAG3, ID_CLASS, ID_DATA, ID_VERSION
+};
+
+static const byte MAG0        = 0x7f; /*!< '\x7f' */
+static const byte MAG1        = 'E';
+static const byte MAG2        = 'L';
+static const byte MAG3        = 'F';
+static const byte CLASS_32    = 1;    /*!< 32-bit objects.           */
+static const byte DATA_LSB    = 1;    /*!< Little endian encoding.   */
+static const Word VERSION     = 1;    /*!< Current version.          */
+static const Half TYPE_EXEC   = 2;    /*!< Executable file.          */
+static const Half MACHINE_MIPS = 8;   /*!< MIPS R3000 and compatible. */
+
+static const Word PT_LOAD     = 1;    /*!< Loadable segment.         */
+
+static const Word PF_X        = 0x1;  /*!< Executable segment.       */
+static const Word PF_W        = 0x2;  /*!< Writable segment.         */
+static const Word PF_R        = 0x4;  /*!< Readable segment.         */
+
+/*! @struct Header Elf.h "proc/Elf.h"
+ * @brief ELF file header (Elf32_Ehdr).
+ */
+struct Header
+{
+	byte ident[IDENT_SIZE];  /*!< Magic and file class.                */
+	Half type;               /*!< Object file type.                    */
+	Half machine;            /*!< Architecture.                        */
+	Word version;            /*!< Object file version.                 */
+	Addr entry;              /*!< Entry point virtual address.         */
+	Off  phoff;              /*!< Program header table file offset.    */
+	Off  shoff;              /*!< Section header table file offset.    */
+	Word flags;              /*!< Processor specific flags.            */
+	Half ehsize;             /*!< ELF header size.                     */
+	Half phentsize;          /*!< Program header table entry size.     */
+	Half phnum;              /*!< Program header table entry count.    */
+	Half shentsize;          /*!< Section header table entry size.     */
+	Half shnum;              /*!< Section header table entry count.    */
+	Half shstrndx;           /*!< Section name string table index.     */
+};
+
+/*! @struct ProgramHeader Elf.h "proc/Elf.h"
+ * @brief Segment description (Elf32_Phdr).
+ */
+struct ProgramHeader
+{
+	Word type;               /*!< Segment type.                        */
+	Off  offset;             /*!< Segment file offset.                 */
+	Addr vaddr;              /*!< Segment virtual address.             */
+	Addr paddr;              /*!< Segment physical address.            */
+	Word filesz;             /*!< Segment size in the file.            */
+	Word memsz;              /*!< Segment size in memory.              */
+	Word flags;              /*!< Segment flags.                       */
+	Word align;              /*!< Segment alignment.                   */
+};
+
+}
@@ -0,0 +1,210 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief ElfLoader class implementation.
+ */
+
+#include "ElfLoader.h"
+#include "api.h"
+#include "flags.h"
+#include "tools.h"
+#include "Pointer.h"
+#include "mem/IVirtualMemoryMap.h"
+#include "mem/FileMapping.h"
+#include "tarfs/FileEntry.h"
+
+//#define ELF_LOADER_DEBUG
+
+#ifndef ELF_LOADER_DEBUG
+#define PRINT_DEBUG(...)
+#else
+#define PRINT_DEBUG(ARGS...) \
+  printf("[ ELF LOADER DEBUG ]: "); \
+  printf(ARGS);
+#endif
+
+/*! @brief Segments are mapped with the smallest pages. */
+static const size_t PAGE_MIN_SIZE = Processor::pages[Processor::PAGE_MIN].size;
+
+/*! @brief Flags used to create areas of segments. */
+static const unsigned int SEGMENT_FLAGS =
+	(VF_VA_USER << VF_VA_SHIFT) | (VF_AT_KUSEG << VF_AT_SHIFT);
+/*----------------------------------------------------------------------------*/
+ElfLoader::ElfLoader( FileEntry* file ):
+	m_file( file ), m_image( NULL ), m_size( file->size() ), m_valid( false ),
+	m_end( 0 ), m_segmentCount( 0 )
+{
+	m_valid = readHeaders();
+}
+/*----------------------------------------------------------------------------*/
+ElfLoader::ElfLoader( const void* image, size_t size ):
+	m_file( NULL ), m_image( (const char*)image ), m_size( size ),
+	m_valid( false ), m_end( 0 ), m_segmentCount( 0 )
+{
+	m_valid = readHeaders();
+}
+/*----------------------------------------------------------------------------*/
+bool ElfLoader::read( void* buffer, size_t size, size_t offset )
+{
+	if (offset > m_size || size > m_size - offset)
+		return false;
+
+	if (m_file)
+		return m_file->readAt( buffer, size, offset ) == (ssize_t)size;
+
+	memcpy( buffer, m_image + offset, size );
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+bool ElfLoader::readHeaders()
+{
+	using namespace Elf;
+
+	if (!read( &m_header, sizeof(m_header), 0 ))
+		return false;
+
+	if (m_header.ident[ID_MAG0] != MAG0 || m_header.ident[ID_MAG1] != MAG1 ||
+	    m_header.ident[ID_MAG2] != MAG2 || m_header.ident[ID_MAG3] != MAG3)
+	{
+		PRINT_DEBUG ("Not an ELF file.\n");
+		return false;
+	}
+
+	if (m_header.ident[ID_CLASS] != CLASS_32 ||
+	    m_header.ident[ID_DATA] != DATA_LSB ||
+	    m_header.type != TYPE_EXEC || m_header.machine != MACHINE_MIPS ||
+	    m_header.version != VERSION ||
+	    m_header.phentsize != sizeof(ProgramHeader))
+	{
+		PRINT_DEBUG ("Unsupported ELF file (type %u, machine %u).\n",
+			m_header.type, m_header.machine);
+		return false;
+	}
+
+	for (uint i = 0; i < m_header.phnum; ++i) {
+		ProgramHeader segment;
+		if (!read( &segment, sizeof(segment), m_header.phoff + i * sizeof(segment) ))
+			return false;
+
+		if (segment.type != PT_LOAD || segment.memsz == 0)
+			continue;
+
+		/* file offset and address have to share the position in the page */
+		if (segment.filesz > segment.memsz ||
+		    segment.offset > m_size || segment.filesz > m_size - segment.offset ||
+		    (segment.offset % PAGE_MIN_SIZE) != (segment.vaddr % PAGE_MIN_SIZE) ||
+		    m_segmentCount == MAX_SEGMENTS)
+		{
+			PRINT_DEBUG ("Segment %u can't be loaded.\n", i);
+			return false;
+		}
+
+		m_segments[m_segmentCount++] = segment;
+		m_end = max<uintptr_t>( m_end,
+			roundUp( segment.vaddr + segment.memsz, PAGE_MIN_SIZE ) );
+
+		PRINT_DEBUG ("Segment %u: %p (%x/%x B) at offset %x, flags %x.\n",
+			i, segment.vaddr, segment.filesz, segment.memsz, segment.offset,
+			segment.flags);
+	}
+
+	return m_segmentCount != 0;
+}
+/*----------------------------------------------------------------------------*/
+bool ElfLoader::load( Pointer<IVirtualMemoryMap> vmm )
+{
+	ASSERT (m_valid);
+
+	for (uint i = 0; i < m_segmentCount; ++i) {
+		const bool success = m_file
+			? mapSegment( vmm, m_segments[i] )
+			: copySegment( vmm, m_segments[i] );
+		if (!success)
+			return false;
+	}
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+bool ElfLoader::mapSegment(
+	Pointer<IVirtualMemoryMap> vmm, const Elf::ProgramHeader& segment )
+{
+	const uintptr_t start = roundDown( segment.vaddr, PAGE_MIN_SIZE );
+	const size_t delta    = segment.vaddr - start;
+	const size_t size     =
+		roundUp( segment.vaddr + segment.memsz, PAGE_MIN_SIZE ) - start;
+
+	/* bytes past the end of file part are zeroed by the mapping (bss) */
+	FileMapping* mapping = FileMapping::create( m_file, segment.offset - delta,
+		segment.filesz + delta, size, segment.flags & Elf::PF_W );
+	if (!mapping)
+		return false;
+
+	void* address = (void*)start;
+	if (vmm->map( &address, size, SEGMENT_FLAGS, mapping ) != EOK) {
+		PRINT_DEBUG ("Failed to map segment at %p (%x B).\n", start, size);
+		delete mapping;
+		return false;
+	}
+
+	PRINT_DEBUG ("Mapped segment at %p (%x B) %s.\n",
+		start, size, (segment.flags & Elf::PF_W) ? "private" : "read only");
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+bool ElfLoader::copySegment(
+	Pointer<IVirtualMemoryMap> vmm, const Elf::ProgramHeader& segment )
+{
+	const uintptr_t start = roundDown( segment.vaddr, PAGE_MIN_SIZE );
+	const uintptr_t end   = roundUp( segment.vaddr + segment.memsz, PAGE_MIN_SIZE );
+
+	void* address = (void*)start;
+	if (vmm->allocate( &address, end - start, SEGMENT_FLAGS ) != EOK) {
+		PRINT_DEBUG ("Failed to allocate segment at %p (%x B).\n", start, end - start);
+		return false;
+	}
+
+	Pointer<IVirtualMemoryMap> current = IVirtualMemoryMap::getCurrent();
+	ASSERT (current);
+
+	current->copyTo( m_image + segment.offset, vmm,
+		(void*)segment.vaddr, segment.filesz );
+
+	/* frames are not cleared by the allocator */
+	static const char zeros[512] = { 0 };
+	const uintptr_t holes[2][2] = {
+		{ start, segment.vaddr },
+		{ segment.vaddr + segment.filesz, end } };
+
+	for (uint i = 0; i < 2; ++i) {
+		for (uintptr_t pos = holes[i][0]; pos < holes[i][1]; ) {
+			const size_t count = min<size_t>( sizeof(zeros), holes[i][1] - pos );
+			current->copyTo( zeros, vmm, (void*)pos, count );
+			pos += count;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,144 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief ElfLoader class declaration.
+ *
+ * ElfLoader reads program headers of an ELF executable and builds the address
+ * space of a new process from its loadable segments.
+ */
+#pragma once
+
+#include "types.h"
+#include "proc/Elf.h"
+
+class FileEntry;
+class IVirtualMemoryMap;
+template <class T> class Pointer;
+
+/*!
+ * @class ElfLoader ElfLoader.h "proc/ElfLoader.h"
+ * @brief Loader of statically linked ELF executables.
+ *
+ * If the executable is a file each PT_LOAD segment becomes one file mapped
+ * area: read only segments (text, rodata) are mapped read only, writable
+ * segments (data, bss) get private mappings. Nothing is read until the
+ * pages are touched, the part of the segment that is not in the file (bss)
+ * is zero filled without touching the file at all.
+ *
+ * Executable in memory (process_create()) is copied eagerly to anonymous
+ * areas, as there is no file to map.
+ */
+class ElfLoader
+{
+public:
+	/*! @brief Maximum number of program headers that are handled. */
+	static const uint MAX_SEGMENTS = 8;
+
+	/*!
+	 * @brief Prepares loading of the executable file.
+	 * @param file Opened executable.
+	 */
+	ElfLoader( FileEntry* file );
+
+	/*!
+	 * @brief Prepares loading of the executable in the current address space.
+	 * @param image Start of the executable.
+	 * @param size Size of the executable.
+	 */
+	ElfLoader( const void* image, size_t size );
+
+	/*!
+	 * @brief Checks that the source is an ELF executable for this machine.
+	 * @return @a true if the headers were read and are usable,
+	 * 	@a false otherwise.
+	 */
+	inline bool valid() const { return m_valid; };
+
+	/*! @brief Gets address of the entry point. */
+	inline void* entry() const { return (void*)m_header.entry; };
+
+	/*! @brief Gets first address above all loaded segments (page aligned). */
+	inline void* end() const { return (void*)m_end; };
+
+	/*!
+	 * @brief Creates areas of all loadable segments in the address space.
+	 * @param vmm Address space of the new process.
+	 * @return @a true on success, @a false otherwise.
+	 * @note Areas that were created are left to be freed with the @a vmm.
+	 */
+	bool load( Pointer<IVirtualMemoryMap> vmm );
+
+private:
+	FileEntry* m_file;            /*!< Executable file, NULL if in memory. */
+	const char* m_image;          /*!< Executable in memory.               */
+	size_t m_size;                /*!< Size of the executable.             */
+	bool m_valid;                 /*!< Headers were read and checked.      */
+	uintptr_t m_end;              /*!< End of the highest segment.         */
+	uint m_segmentCount;          /*!< Number of loadable segments.        */
+
+	Elf::Header m_header;                          /*!< File header. */
+	Elf::ProgramHeader m_segments[MAX_SEGMENTS];   /*!< PT_LOAD headers. */
+
+	/*!
+	 * @brief Reads and checks headers.
+	 * @return @a true if the executable can be loaded, @a false otherwise.
+	 */
+	bool readHeaders();
+
+	/*!
+	 * @brief Reads part of the executable.
+	 * @param buffer Destination buffer.
+	 * @param size Number of bytes to read.
+	 * @param offset Position in the executable.
+	 * @return @a true if all the bytes were read, @a false otherwise.
+	 */
+	bool read( void* buffer, size_t size, size_t offset );
+
+	/*!
+	 * @brief Creates file mapped area of the segment.
+	 * @param vmm Target address space.
+	 * @param segment Segment to map.
+	 * @return @a true on success, @a false otherwise.
+	 */
+	bool mapSegment( Pointer<IVirtualMemoryMap> vmm,
+		const Elf::ProgramHeader& segment );
+
+	/*!
+	 * @brief Creates anonymous area of the segment and copies its content.
+	 * @param vmm Target address space.
+	 * @param segment Segment to copy.
+	 * @return @a true on success, @a false otherwise.
+	 */
+	bool copySegment( Pointer<IVirtualMemoryMap> vmm,
+		const Elf::ProgramHeader& segment );
+
+	/*! @brief No copying. */
+	ElfLoader( const ElfLoader& );
+
+	/*! @brief No assigning. */
+	ElfLoader& operator = ( const ElfLoader& );
+};
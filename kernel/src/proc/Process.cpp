@@ -43,6 +43,12 @@
 #include "ProcessInfo.h"
 #include "ProcessTable.h"
 #include "tarfs/Entry.h"
+#include "tarfs/FileEntry.h"
+#include "tarfs/OpenFile.h"
+#include "tarfs/AsyncReader.h"
+#include "proc/ElfLoader.h"
+#include "stat.h"
+#include "Kernel.h"
 
 //#define PROCESS_DEBUG
 
@@ -55,19 +61,102 @@
 #endif
 
 
+/*! @brief Address the flat process image is loaded at. */
+static char* const IMAGE_START = (char*)0x1000000;
+/*----------------------------------------------------------------------------*/
 Process* Process::create( const void* image, size_t size )
 {
 	InterruptDisabler inter;
 
-	PRINT_DEBUG ("Creating process.\n");
+	ElfLoader elf( image, size );
+	if (elf.valid())
+		return create( elf );
 
-	void * (*start)(void*) = (void*(*)(void*))0x1000000;
-	const size_t request = roundUp( size + sizeof(ProcessInfo), Processor::pages[Processor::PAGE_MIN].size );
+	PRINT_DEBUG ("Creating process from flat image.\n");
 
-	ProcessInfo * info   = (ProcessInfo*)((char*)start + request - sizeof(ProcessInfo));
-	
-	PRINT_DEBUG ("Requested size: %x,%x(%p), info at %p.\n", size, request, start, info);
+	ProcessInfo* info = flatInfo( size );
+	UserThread* main = prepareMain( (void*(*)(void*))IMAGE_START, info );
+	if (!main)
+		return NULL;
+
+	if (!prepareFlat( main->getVMM(), size )) {
+		delete main;
+		return NULL;
+	}
+
+	Pointer<IVirtualMemoryMap> old_vmm = IVirtualMemoryMap::getCurrent();
+	ASSERT (old_vmm);
+	ASSERT (old_vmm != main->getVMM());
+
+	old_vmm->copyTo( image, main->getVMM(), IMAGE_START, size );
+
+	return launch( main, info );
+}
+/*----------------------------------------------------------------------------*/
+Process* Process::create( FileEntry* file )
+{
+	InterruptDisabler inter;
+
+	ASSERT (file);
+
+	ElfLoader elf( file );
+	if (elf.valid())
+		return create( elf );
+
+	const size_t size = file->size();
+	PRINT_DEBUG ("Creating process from flat file (%u B).\n", size);
+
+	ProcessInfo* info = flatInfo( size );
+	UserThread* main = prepareMain( (void*(*)(void*))IMAGE_START, info );
+	if (!main)
+		return NULL;
+
+	if (!prepareFlat( main->getVMM(), size ) ||
+	    !loadImage( file, main->getVMM(), size )) {
+		PRINT_DEBUG ("Loading image failed.\n");
+		delete main;
+		return NULL;
+	}
+
+	return launch( main, info );
+}
+/*----------------------------------------------------------------------------*/
+Process* Process::create( ElfLoader& elf )
+{
+	/* ProcessInfo gets its own page above the highest segment */
+	ProcessInfo* info = (ProcessInfo*)elf.end();
+
+	PRINT_DEBUG ("Creating process from ELF, entry %p, info at %p.\n",
+		elf.entry(), info);
+
+	UserThread* main = prepareMain( (void*(*)(void*))elf.entry(), info );
+	if (!main)
+		return NULL;
+
+	Pointer<IVirtualMemoryMap> vmm = main->getVMM();
+	const unative_t flags = (VF_VA_USER << VF_VA_SHIFT) | (VF_AT_KUSEG << VF_AT_SHIFT);
+	void* info_page = info;
+
+	if (!elf.load( vmm ) || vmm->allocate(
+	    &info_page, Processor::pages[Processor::PAGE_MIN].size, flags ) != EOK)
+	{
+		PRINT_DEBUG ("Loading segments failed.\n");
+		delete main;
+		return NULL;
+	}
 
+	return launch( main, info );
+}
+/*----------------------------------------------------------------------------*/
+ProcessInfo* Process::flatInfo( size_t size )
+{
+	const size_t request = roundUp( size + sizeof(ProcessInfo), Processor::pages[Processor::PAGE_MIN].size );
+	return (ProcessInfo*)(IMAGE_START + request - sizeof(ProcessInfo));
+}
+/*----------------------------------------------------------------------------*/
+UserThread* Process::prepareMain( void* (*start)(void*), ProcessInfo* info )
+{
+	PRINT_DEBUG ("Preparing main thread at %p, info at %p.\n", start, info);
 
 	UserThread* main = new UserThread(
 		start, info, NULL, (char*)ADDR_PREFIX_KSEG0 - Thread::DEFAULT_STACK_SIZE, TF_NEW_VMM );
@@ -86,27 +175,71 @@ Process* Process::create( const void* image, size_t size )
 		return NULL;
 	}
 
-	Pointer<IVirtualMemoryMap> vmm = main->getVMM();
+	return main;
+}
+/*----------------------------------------------------------------------------*/
+bool Process::prepareFlat( Pointer<IVirtualMemoryMap> vmm, size_t size )
+{
+	void* start = IMAGE_START;
+	const size_t request = roundUp( size + sizeof(ProcessInfo), Processor::pages[Processor::PAGE_MIN].size );
 
-	PRINT_DEBUG ("Mapping main area.\n");
+	PRINT_DEBUG ("Mapping main area: %x,%x(%p).\n", size, request, start);
 
 	const unative_t flags = (VF_VA_USER << VF_VA_SHIFT) | (VF_AT_KUSEG << VF_AT_SHIFT);
 
-
 	/* Space allocation may fail. */
-	if (vmm->allocate( (void**)&start, request, flags ) != EOK) {
+	if (vmm->allocate( &start, request, flags ) != EOK) {
 		PRINT_DEBUG ("Main area allocation failed.\n");
-		delete main;
-		return NULL;
+		return false;
 	}
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+bool Process::loadImage(
+	FileEntry* file, Pointer<IVirtualMemoryMap> vmm, size_t size )
+{
+	/* Image is read straight into the frames of the new process, using their
+	 * KSEG0 addresses. Frames that KSEG0 can't reach go through a small
+	 * buffer. */
+	const size_t BUFFER_SIZE = 512;
+	char buffer[BUFFER_SIZE];
 
-	Pointer<IVirtualMemoryMap> old_vmm = IVirtualMemoryMap::getCurrent();
-	ASSERT (old_vmm);
-	ASSERT (old_vmm != vmm);
+	size_t pos = 0;
+	while (pos < size) {
+		void* address = IMAGE_START + pos;
+		Processor::PageSize frame_type;
+		bool writable;
+		if (!vmm->translate( address, frame_type, writable ))
+			return false;
 
+		/* translate gives the start of the frame */
+		const size_t frame_size = Processor::pages[frame_type].size;
+		const size_t in_frame   = (uintptr_t)(IMAGE_START + pos) & (frame_size - 1);
+		const uintptr_t phys    = (uintptr_t)address + in_frame;
+		const size_t count      = min( frame_size - in_frame, size - pos );
 
-	old_vmm->copyTo( image, vmm, (void*)start, size );
+		if ((phys + count) <= ADDR_SIZE_KSEG0) {
+			if (file->readAt( (void*)ADDR_TO_KSEG0( phys ), count, pos ) != (ssize_t)count)
+				return false;
+			pos += count;
+			continue;
+		}
 
+		for (size_t done = 0; done < count; ) {
+			const size_t part = min( BUFFER_SIZE, count - done );
+			if (file->readAt( buffer, part, pos + done ) != (ssize_t)part)
+				return false;
+			IVirtualMemoryMap::getCurrent()->copyTo(
+				buffer, vmm, IMAGE_START + pos + done, part );
+			done += part;
+		}
+		pos += count;
+	}
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+Process* Process::launch( UserThread* main, ProcessInfo* info )
+{
 	Process* me  = new Process();
 	me->m_id     = PIDTable.getFreeId( me );
 
@@ -116,7 +249,13 @@ Process* Process::create( const void* image, size_t size )
 		return NULL;
 	}
 
-	old_vmm->copyTo( &(me->m_id), vmm, (void*)info, sizeof( me->m_id ) );
+	IVirtualMemoryMap::getCurrent()->copyTo(
+		&(me->m_id), main->getVMM(), (void*)info, sizeof( me->m_id ) );
+
+	/* empty syscall ring, indices are at its start */
+	const uint ring_indices[4] = { 0, 0, 0, 0 };
+	IVirtualMemoryMap::getCurrent()->copyTo(
+		ring_indices, main->getVMM(), (void*)&info->Ring, sizeof( ring_indices ) );
 
 	me->m_mainThread = main;
 	me->m_mainThread->resume();
@@ -131,6 +270,41 @@ void Process::setActiveThread( thread_t thread )
 {
 	m_info->RunningThread = thread;
 //	PRINT_DEBUG ("Setting active thread for process %u: %u.(%u,%u)\n", m_id, thread, m_info->PID, m_info->RunningThread);
+	updateClock();
+}
+/*----------------------------------------------------------------------------*/
+void Process::updateClock()
+{
+	const Time now = Time::getCurrentTime();
+	++m_info->ClockSequence;
+	m_info->ClockSecs  = now.secs();
+	m_info->ClockUsecs = now.usecs();
+	++m_info->ClockSequence;
+}
+/*----------------------------------------------------------------------------*/
+void Process::stat( process_stat& stat )
+{
+	InterruptDisabler inter;
+
+	stat.pid = m_id;
+	stat.threads = m_list.size() + (m_mainThread ? 1 : 0);
+	stat.cpu_cycles = m_cpuCycles;
+	stat.cycles_per_usec = KERNEL.cyclesPerUsec();
+	stat.syscalls = m_syscalls;
+	stat.tlb_refills = m_tlbRefills;
+	stat.read_bytes = m_readBytes;
+	stat.written_bytes = m_writtenBytes;
+
+	stat.areas = 0;
+	stat.resident = 0;
+	stat.shared = 0;
+	if (m_mainThread && m_mainThread->getVMM())
+		m_mainThread->getVMM()->usage( stat.areas, stat.resident, stat.shared );
+
+	/* add the slice of the thread running right now */
+	Thread* current = Thread::getCurrent();
+	if (current && current->process() == this)
+		stat.cpu_cycles += Processor::reg_read_count() - current->m_lastSwitch;
 }
 /*----------------------------------------------------------------------------*/
 void Process::clearEvents()
@@ -160,13 +334,14 @@ void Process::clearFiles()
 	const uint list_count = fileTable.map().getArraySize();
 	for (uint i = 0; i < list_count; ++i)
 	{
-		List< Pair<file_t, Entry*> >* list =	fileTable.map().getList( i );
-		List< Pair<file_t, Entry*> >::Iterator it;
+		List< Pair<file_t, OpenFile*> >* list =	fileTable.map().getList( i );
+		List< Pair<file_t, OpenFile*> >::Iterator it;
 		ASSERT (list);
 		for (it = list->begin(); it != list->end(); ++it) {
 			if (it->second) {
 				PRINT_DEBUG ("CLOSING file with fd %u.\n", it->first);
-				it->second->close();
+				it->second->entry()->close();
+				delete it->second;
 			}
 		}
 		list->clear();
@@ -190,9 +365,12 @@ void Process::clearThreads()
 /*----------------------------------------------------------------------------*/
 void Process::exit()
 {
+	AsyncReader::instance().cancel( this );
 	clearEvents();
 	clearFiles();
 	clearThreads();
+	/* callers delete the process, do not let anyone find it */
+	PIDTable.returnId( m_id );
 }
 /*----------------------------------------------------------------------------*/
 Process* Process::getCurrent()
@@ -44,16 +44,22 @@ class  Event;
 class  Process;
 class  Time;
 class  Entry;
+class  FileEntry;
+class  OpenFile;
+class  IVirtualMemoryMap;
+class  ElfLoader;
+template <class T> class Pointer;
 struct ProcessInfo;
+struct process_stat;
 
 template class List<UserThread*>;
 template class IdMap<event_t, Event*>;
 template class IdMap<process_t, Process*>;
-template class IdMap<file_t, Entry*>;
+template class IdMap<file_t, OpenFile*>;
 
 typedef List<UserThread*>          UserThreadList;
 typedef IdMap<event_t, Event*>     EventTable;
-typedef IdMap<file_t, Entry*>      FileTable;
+typedef IdMap<file_t, OpenFile*>   FileTable;
 
 /*!
  * @class Process Process.h "proc/Process.h"
@@ -74,9 +80,24 @@ public:
 	 * @param image Program to run.
 	 * @param size Size of the prorgam image.
 	 * @return Ptr to the newly created process on success, NULL on failure.
+	 *
+	 * ELF executables are loaded segment by segment, anything else is
+	 * treated as a flat image linked at 0x1000000.
 	 */
 	static Process* create( const void* image, size_t size );
 
+	/*!
+	 * @brief Creates new process from the executable file.
+	 * @param file File containing the program image.
+	 * @return Ptr to the newly created process on success, NULL on failure.
+	 *
+	 * Segments of ELF executables are file mapped: text is read only and
+	 * loaded on demand, data are private to the process, bss is zero filled
+	 * when touched. Flat image is read from the disk directly to the memory
+	 * of the new process, no intermediate copy is made.
+	 */
+	static Process* create( FileEntry* file );
+
 	/*!
 	 * @brief Gets pointer to the Process of the currrently running thread.
 	 * @return Ptr to the Process, NULL if the current thread does not belogn to 
@@ -90,6 +111,12 @@ public:
 	 */
 	inline UserThread* mainThread() { return m_mainThread; };
 
+	/*!
+	 * @brief Gets information exported to the process, a userspace address.
+	 * @return Ptr to the ProcessInfo, valid while the process is active.
+	 */
+	inline ProcessInfo* info() { return m_info; };
+
 	/*!
 	 * @brief Starts new thread within the process.
 	 * @param thread_ptr Place to store the assigned thread ID.
@@ -147,6 +174,37 @@ public:
 	 */
 	void setActiveThread( thread_t );
 
+	/*!
+	 * @brief Exports the current time, the process has to be active.
+	 *
+	 * Called on timer interrupts and thread switches, see
+	 * Time::getCoarseTime().
+	 */
+	void updateClock();
+
+	/*! @brief Adds CPU time of one of the threads, in cycles. */
+	inline void accountCpu( uint64_t cycles ) { m_cpuCycles += cycles; };
+
+	/*! @brief Counts one syscall trap. */
+	inline void countSyscall() { ++m_syscalls; };
+
+	/*! @brief Counts one TLB refill. */
+	inline void countTlbRefill() { ++m_tlbRefills; };
+
+	/*! @brief Counts bytes read from a file, failed reads are ignored. */
+	inline void countRead( int bytes )
+		{ if (bytes > 0) m_readBytes += bytes; };
+
+	/*! @brief Counts bytes written to a file, failed writes are ignored. */
+	inline void countWritten( int bytes )
+		{ if (bytes > 0) m_writtenBytes += bytes; };
+
+	/*!
+	 * @brief Fills in accounting of the process.
+	 * @param stat Structure to fill.
+	 */
+	void stat( process_stat& stat );
+
 	/*! @brief Events used by this process. */
 	EventTable eventTable;
 
@@ -160,8 +218,63 @@ private:
 	process_t     m_id;            /*!< Assigned id.                      */
 	ProcessInfo * m_info;          /*!< Position of exported information. */
 
-	/*! @brief Nothing here. */
-	inline Process(){};
+	uint64_t m_cpuCycles;          /*!< CPU time of all threads.          */
+	uint     m_syscalls;           /*!< Syscall traps.                    */
+	uint     m_tlbRefills;         /*!< TLB refills.                      */
+	uint64_t m_readBytes;          /*!< Bytes read from files.            */
+	uint64_t m_writtenBytes;       /*!< Bytes written to files.           */
+
+	/*! @brief Clears the counters, nothing else here. */
+	inline Process(): m_cpuCycles( 0 ), m_syscalls( 0 ), m_tlbRefills( 0 ),
+		m_readBytes( 0 ), m_writtenBytes( 0 ) {};
+
+	/*!
+	 * @brief Creates process from the ELF executable.
+	 * @param elf Loader with valid headers.
+	 * @return Ptr to the newly created process on success, NULL on failure.
+	 */
+	static Process* create( ElfLoader& elf );
+
+	/*!
+	 * @brief Gets position of exported information for the flat image.
+	 * @param size Size of the process image.
+	 * @return Address of the ProcessInfo at the end of the image area.
+	 */
+	static ProcessInfo* flatInfo( size_t size );
+
+	/*!
+	 * @brief Creates main thread of the new process.
+	 * @param start Entry point of the process.
+	 * @param info Position of exported information, passed to @a start.
+	 * @return Ptr to the main thread (not running yet), NULL on failure.
+	 */
+	static UserThread* prepareMain( void* (*start)(void*), ProcessInfo* info );
+
+	/*!
+	 * @brief Allocates space for the flat process image.
+	 * @param vmm Address space of the new process.
+	 * @param size Size of the process image.
+	 * @return @a True on success, @a false otherwise.
+	 */
+	static bool prepareFlat( Pointer<IVirtualMemoryMap> vmm, size_t size );
+
+	/*!
+	 * @brief Reads process image from the file to the new address space.
+	 * @param file File to read.
+	 * @param vmm Address space of the new process.
+	 * @param size Size of the image.
+	 * @return @a True on success, @a false otherwise.
+	 */
+	static bool loadImage(
+		FileEntry* file, Pointer<IVirtualMemoryMap> vmm, size_t size );
+
+	/*!
+	 * @brief Creates Process around the prepared main thread and starts it.
+	 * @param main Main thread returned by prepareMain().
+	 * @param info Position of exported information.
+	 * @return Ptr to the new process on success, NULL on failure.
+	 */
+	static Process* launch( UserThread* main, ProcessInfo* info );
 
 	/*! @brief Destroys all used Event instances. */
 	void clearEvents();
@@ -35,6 +35,7 @@
 #include "Thread.h"
 #include "InterruptDisabler.h"
 #include "Kernel.h"
+#include "Tracer.h"
 
 //#define SCHEDULER_DEBUG
 
@@ -89,6 +90,7 @@ void Scheduler::enqueue( Thread* thread )
 	 */
 	thread->append(&m_activeThreadList);
 	PRINT_DEBUG ("Enqueued thread: %d.\n", thread->id());
+	TRACE( ENQUEUE, thread->id(), 0 );
 	thread->setStatus( Thread::READY );
 
 	/* if the idle thread is running and other thread became ready,
@@ -108,5 +110,6 @@ void Scheduler::dequeue( Thread* thread )
 
 	thread->remove();
 	PRINT_DEBUG("Dequeuing thread %u.\n", thread->id());
+	TRACE( DEQUEUE, thread->id(), 0 );
 }
 /*----------------------------------------------------------------------------*/
@@ -38,6 +38,9 @@
 #include "timer/Timer.h"
 #include "proc/ThreadCollector.h"
 #include "proc/Process.h"
+#include "mem/StackPool.h"
+#include "stat.h"
+#include "Tracer.h"
 
 //#define THREAD_DEBUG
 
@@ -79,13 +82,18 @@ void Thread::requestSwitch()
 /*----------------------------------------------------------------------------*/
 Thread::Thread( uint stackSize ):
 	ListInsertable<Thread>(),
-	HeapInsertable<Thread, Time, THREAD_HEAP_CHILDREN>(), m_otherStackTop( NULL ),
-	m_stackSize( stackSize ),	m_detached( false ), m_status( UNINITIALIZED ),
-	m_id( 0 ), m_follower( NULL ), m_joinTarget( NULL ), m_virtualMap( NULL )
+	HeapInsertable<Thread, Time, THREAD_HEAP_CHILDREN>(), m_stack( NULL ),
+	m_otherStackTop( NULL ),
+	m_stackSize( stackSize ), m_process( NULL ),
+	m_detached( false ), m_status( UNINITIALIZED ),
+	m_id( 0 ), m_follower( NULL ), m_joinTarget( NULL ), m_virtualMap( NULL ),
+	m_cpuCycles( 0 ), m_waitCycles( 0 ),
+	m_lastSwitch( Processor::reg_read_count() ),
+	m_voluntary( 0 ), m_involuntary( 0 )
 {
 	if (!m_stackSize) return;
-	/* Alloc stack */
-	m_stack = malloc( m_stackSize );
+	/* Alloc stack, recycled one if possible */
+	m_stack = STACK_POOL.get( m_stackSize );
 	if (m_stack == NULL) return;  /* test stack */
 
 	/* stack is created OK */
@@ -132,6 +140,27 @@ void Thread::switchTo()
 	void** old_stack = &(old_thread->m_stackTop);
 	void** new_stack = &m_stackTop;
 
+	if (old_thread != this) {
+		TRACE( SWITCH, old_thread->id(), id() );
+
+		/* Count wraps in minutes, unsigned difference handles one wrap */
+		const unative_t now = Processor::reg_read_count();
+		const unative_t ran = now - old_thread->m_lastSwitch;
+		old_thread->m_cpuCycles += ran;
+		/* process of a dying thread might be already deleted */
+		if (old_thread->m_process && old_thread->status() != KILLED
+		    && old_thread->status() != UNINITIALIZED)
+			old_thread->m_process->accountCpu( ran );
+		if (old_thread->status() == RUNNING && SCHEDULER.m_shouldSwitch)
+			++old_thread->m_involuntary;
+		else
+			++old_thread->m_voluntary;
+		old_thread->m_lastSwitch = now;
+
+		m_waitCycles += now - m_lastSwitch;
+		m_lastSwitch = now;
+	}
+
 	if (old_thread->status() == RUNNING)
 		old_thread->setStatus( READY );
 
@@ -166,6 +195,22 @@ void Thread::switchTo()
 	THREAD_BIN.clean();
 }
 /*----------------------------------------------------------------------------*/
+void Thread::stat( thread_stat& stat )
+{
+	InterruptDisabler interrupts;
+
+	stat.cpu_cycles  = m_cpuCycles;
+	stat.wait_cycles = m_waitCycles;
+	stat.voluntary   = m_voluntary;
+	stat.involuntary = m_involuntary;
+
+	const unative_t slice = Processor::reg_read_count() - m_lastSwitch;
+	if (this == getCurrent())
+		stat.cpu_cycles += slice;
+	else
+		stat.wait_cycles += slice;
+}
+/*----------------------------------------------------------------------------*/
 void Thread::yield()
 {
 	InterruptDisabler inter;
@@ -404,5 +449,5 @@ Thread::~Thread()
 		SCHEDULER.returnId( m_id );
 	}
 	PRINT_DEBUG ("Freeing stack.\n");
-	free(m_stack);
+	STACK_POOL.put( m_stack, m_stackSize );
 }
@@ -40,6 +40,7 @@
 
 template class Pointer<IVirtualMemoryMap>;
 class Process;
+struct thread_stat;
 
 #define THREAD_HEAP_CHILDREN 4
 
@@ -196,10 +197,26 @@ public:
 	inline void setStatus( Status status ) { m_status = status; };
 	
 	inline Pointer<IVirtualMemoryMap> getVMM() { return m_virtualMap; }
+
+	/*!
+	 * @brief Replaces address space of the thread.
+	 * @param vmm New address space, NULL for none.
+	 * @note Takes effect on the next switch to the thread, call
+	 * 	IVirtualMemoryMap::switchTo() as well when changing own map.
+	 */
+	inline void setVMM( Pointer<IVirtualMemoryMap> vmm ) { m_virtualMap = vmm; }
 	
 	/*! @brief Sets my thread_t identifier. */
 	thread_t registerWithScheduler();
 
+	/*! @brief Fills in accounting of the thread.
+	 *
+	 * Time since the last switch is added to the CPU time if the thread is
+	 * running, to the wait time otherwise.
+	 * @param stat Structure to fill.
+	 */
+	void stat( thread_stat& stat );
+
 protected:
 	void*  m_stack;                            /*!< that's my stack            */
 	void*  m_stackTop;                         /*!< top of my stack            */
@@ -215,6 +232,12 @@ protected:
 	Thread* m_joinTarget;                      /*!< I'm waiting for this       */
 	Pointer<IVirtualMemoryMap> m_virtualMap;   /*!< @brief Virtual Memory Map. */
 
+	uint64_t  m_cpuCycles;                     /*!< time spent running         */
+	uint64_t  m_waitCycles;                    /*!< time spent off the CPU     */
+	unative_t m_lastSwitch;                    /*!< Count at the last switch   */
+	uint      m_voluntary;                     /*!< blocked or yielded         */
+	uint      m_involuntary;                   /*!< preempted                  */
+
 private:
 	Thread( const Thread& other );              /*!< no copying   */
 	Thread& operator = ( const Thread& other ); /*!< no assigning */
@@ -28,6 +28,8 @@
  * @brief Class Event definition - the simplest synchronization primitive.
  */
 
+#pragma once
+
 #include "structures/List.h"
 
 class Time;
@@ -0,0 +1,228 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief AsyncReader class implementation.
+ */
+#include "AsyncReader.h"
+#include "OpenFile.h"
+#include "InterruptDisabler.h"
+#include "proc/Process.h"
+#include "proc/KernelThread.h"
+#include "synchronization/Event.h"
+#include "mem/IVirtualMemoryMap.h"
+#include "tools.h"
+
+//#define ASYNC_READER_DEBUG
+
+#ifndef ASYNC_READER_DEBUG
+#define PRINT_DEBUG(...)
+#else
+#define PRINT_DEBUG(ARGS...) \
+  printf("[ ASYNC READER DEBUG ]: "); \
+  printf(ARGS);
+#endif
+
+/*----------------------------------------------------------------------------*/
+int AsyncReader::submit( AIO_READ* request )
+{
+	Process* process = Process::getCurrent();
+	ASSERT (process);
+	Pointer<IVirtualMemoryMap> vmm = IVirtualMemoryMap::getCurrent();
+	ASSERT (vmm);
+
+	/* workers complete the record through its frames */
+	if (((uintptr_t)request % sizeof(native_t))
+		|| !vmm->writable( request, sizeof(AIO_READ) ))
+		return EINVAL;
+
+	OpenFile* opened = process->fileTable.translateId( request->fd );
+	Event* event = process->eventTable.translateId( request->event );
+	if (!opened || !opened->file() || !event)
+		return EINVAL;
+
+	FileEntry* file = opened->file();
+	/* like fread(), reads past the end are cut short */
+	const size_t size = (request->offset < file->size())
+		? min<size_t>( request->size, file->size() - request->offset ) : 0;
+	if (!vmm->writable( request->buffer, size ))
+		return EINVAL;
+
+	if (!file->open( OPEN_R ))
+		return EINVAL;
+
+	Job* job = new Job;
+	if (!job) {
+		file->close();
+		return ENOMEM;
+	}
+	job->process = process;
+	job->vmm     = vmm;
+	job->file    = file;
+	job->request = request;
+	job->event   = event;
+	job->buffer  = request->buffer;
+	job->size    = size;
+	job->offset  = request->offset;
+
+	InterruptDisabler inter;
+
+	while (m_workers < WORKERS) {
+		thread_t id;
+		Thread* thread = KernelThread::create( &id, worker, this );
+		if (!thread) break;
+		/* workers reach user memory only through kernel addresses */
+		thread->setVMM( NULL );
+		++m_workers;
+		PRINT_DEBUG ("Started worker %u.\n", id);
+	}
+	if (!m_workers) {
+		file->close();
+		delete job;
+		return ENOMEM;
+	}
+
+	request->result  = 0;
+	request->pending = 1;
+	job->append( &m_queued );
+	m_pending.up();
+
+	PRINT_DEBUG ("Queued read of %u bytes at %u.\n", job->size, job->offset);
+	return EOK;
+}
+/*----------------------------------------------------------------------------*/
+void AsyncReader::cancel( Process* process )
+{
+	List<Job*> dropped;
+	{
+		InterruptDisabler inter;
+
+		for (List<Job*>::Iterator it = m_queued.begin(); it != m_queued.end();) {
+			Job* job = *it++;
+			if (job->process == process)
+				job->append( &dropped );
+		}
+		for (List<Job*>::Iterator it = m_running.begin(); it != m_running.end(); ++it)
+			if ((*it)->process == process)
+				(*it)->process = NULL;
+	}
+
+	/* m_pending keeps counting them, serve() skips the missing jobs */
+	while (!dropped.empty()) {
+		Job* job = dropped.getFront();
+		PRINT_DEBUG ("Dropped read of %u bytes at %u.\n", job->size, job->offset);
+		job->file->close();
+		delete job;
+	}
+}
+/*----------------------------------------------------------------------------*/
+void* AsyncReader::worker( void* reader )
+{
+	((AsyncReader*)reader)->serve();
+	return NULL;
+}
+/*----------------------------------------------------------------------------*/
+void AsyncReader::serve()
+{
+	while (true) {
+		m_pending.down();
+
+		Job* job;
+		{
+			InterruptDisabler inter;
+			/* cancel() might have dropped the job */
+			if (m_queued.empty())
+				continue;
+			job = m_queued.getFront();
+			job->append( &m_running );
+		}
+		run( job );
+	}
+}
+/*----------------------------------------------------------------------------*/
+int AsyncReader::read( Job* job )
+{
+	char* buffer = (char*)job->buffer;
+	size_t done = 0;
+
+	while (done < job->size) {
+		size_t left;
+		char* target = (char*)job->vmm->kernelAddress( buffer + done, left );
+		if (!target)
+			return EIO;
+
+		/* physically contiguous frames are read at once */
+		size_t chunk = min( left, job->size - done );
+		while (done + chunk < job->size) {
+			const char* next =
+				(char*)job->vmm->kernelAddress( buffer + done + chunk, left );
+			if (next != target + chunk)
+				break;
+			chunk += min( left, job->size - done - chunk );
+		}
+
+		const int res = job->file->readAt( target, chunk, job->offset + done );
+		PRINT_DEBUG ("Read %d bytes at %u.\n", res, job->offset + done);
+		if (res < 0)
+			return res;
+		done += res;
+		if ((size_t)res < chunk)
+			break;
+	}
+	return done;
+}
+/*----------------------------------------------------------------------------*/
+void AsyncReader::run( Job* job )
+{
+	/* frames of the buffer and the record stay while the map is pinned */
+	job->vmm->pin();
+
+	const int result = job->process ? read( job ) : EKILLED;
+
+	size_t left;
+	int* result_field = (int*)job->vmm->kernelAddress(
+		const_cast<int*>(&job->request->result), left );
+	native_t* pending_field = (native_t*)job->vmm->kernelAddress(
+		const_cast<native_t*>(&job->request->pending), left );
+
+	{
+		InterruptDisabler inter;
+		/* owner might have exited while the data were read */
+		if (job->process) {
+			if (result_field && pending_field) {
+				*result_field  = result;
+				*pending_field = 0;
+			}
+			job->event->fire();
+		}
+		job->remove();
+	}
+
+	job->vmm->unpin();
+	job->file->close();
+	delete job;
+}
+/*----------------------------------------------------------------------------*/
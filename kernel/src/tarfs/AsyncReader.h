@@ -0,0 +1,130 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief AsyncReader class declaration.
+ *
+ * Asynchronous reads of files requested by SYS_FS_READ_ASYNC.
+ */
+#pragma once
+
+#include "api.h"
+#include "aio.h"
+#include "Singleton.h"
+#include "Pointer.h"
+#include "structures/ListInsertable.h"
+#include "synchronization/Semaphore.h"
+
+class Event;
+class FileEntry;
+class Process;
+class IVirtualMemoryMap;
+
+/*!
+ * @class AsyncReader AsyncReader.h "tarfs/AsyncReader.h"
+ * @brief Serves asynchronous read requests of user processes.
+ *
+ * Requests are queued and served by WORKERS kernel threads, so a single
+ * user thread can have several reads in flight (they meet in the disk
+ * queue) and compute while the data are transferred. Data go directly to
+ * the frames of the user buffer, workers reach them through kernel
+ * addresses, so a bad user address fails the request with EIO instead of
+ * killing the worker.
+ *
+ * When the read is done the completion record in user memory is updated
+ * and the event is fired. Event of a request must not be destroyed before
+ * the request completes.
+ */
+class AsyncReader: public Singleton<AsyncReader>
+{
+public:
+	/*! @brief Number of reads served at the same time. */
+	static const uint WORKERS = 4;
+
+	/*!
+	 * @brief Queues read described by the user record.
+	 * @param request Record in the user memory of the current process.
+	 * @retval EOK if the read was queued.
+	 * @retval EINVAL if the file or the event is not valid, or the record
+	 * 	or the buffer is not mapped and writable.
+	 * @retval ENOMEM if there is no memory to queue the request.
+	 */
+	int submit( AIO_READ* request );
+
+	/*!
+	 * @brief Forgets requests of the exiting process.
+	 * @param process The process.
+	 *
+	 * Queued reads are removed and freed, running ones finish without
+	 * touching the records or events of the process.
+	 */
+	void cancel( Process* process );
+
+private:
+	/*! @brief Queued or running read. */
+	struct Job: public ListInsertable<Job> {
+		Process* process;                /*!< Owner, NULL if it exited.  */
+		Pointer<IVirtualMemoryMap> vmm;  /*!< Address space of the owner.*/
+		FileEntry* file;                 /*!< File to read.              */
+		AIO_READ* request;               /*!< User completion record.    */
+		Event* event;                    /*!< Event to fire.             */
+		void* buffer;                    /*!< User destination.          */
+		size_t size;                     /*!< Bytes to read.             */
+		size_t offset;                   /*!< Position in the file.      */
+	};
+
+	List<Job*> m_queued;          /*!< Requests waiting for a worker.    */
+	List<Job*> m_running;         /*!< Requests being served.            */
+	Semaphore m_pending;          /*!< Queued requests, dropped included.*/
+	uint m_workers;               /*!< Number of started workers.        */
+
+	/*! @brief Creates empty queue, workers start on the first request. */
+	AsyncReader(): m_pending( 0 ), m_workers( 0 ) {};
+
+	/*! @brief Serves requests, never returns. */
+	void serve();
+
+	/*!
+	 * @brief Reads the data and completes the request.
+	 * @param job Request to serve.
+	 */
+	void run( Job* job );
+
+	/*!
+	 * @brief Reads the data to the frames of the user buffer.
+	 * @param job Request to serve, its map has to be pinned.
+	 * @return Number of bytes read or error code.
+	 */
+	int read( Job* job );
+
+	/*!
+	 * @brief Worker thread entry point.
+	 * @param reader AsyncReader to serve.
+	 */
+	static void* worker( void* reader );
+
+	friend class Singleton<AsyncReader>;
+};
@@ -25,11 +25,7 @@
 
 /*!
  * @file
- * @brief Short description.
- *
- * Long description. I would paste some Loren Ipsum rubbish here, but I'm afraid
- * It would stay that way. Not that this comment is by any means ingenious but
- * at least people can understand it.
+ * @brief DirEntry class implementation.
  */
 
 #include "api.h"
@@ -46,79 +42,163 @@
 	  printf(ARGS);
 #endif
 
-bool DirEntry::addSubEntry( char* name, Entry* entry )
+DirEntry::DirEntry( DiskDevice* storage ):
+	Entry( storage ), m_buckets( NULL ), m_bucketCount( 0 ), m_count( 0 ),
+	m_first( NULL ), m_last( NULL ), m_opencount( 0 ), m_nextEntry( NULL )
+{}
+/*----------------------------------------------------------------------------*/
+uint DirEntry::hash( const char* name, uint length )
+{
+	uint result = 2166136261u;
+	for (uint i = 0; i < length; ++i) {
+		result ^= (byte)name[i];
+		result *= 16777619u;
+	}
+	return result;
+}
+/*----------------------------------------------------------------------------*/
+DirEntry::Name* DirEntry::find( const char* name, uint length ) const
+{
+	if (!m_bucketCount)
+		return NULL;
+
+	const uint name_hash = hash( name, length );
+	for (Name* stored = m_buckets[name_hash & (m_bucketCount - 1)];
+		stored; stored = stored->chain) {
+		if (stored->hash != name_hash || stored->length != length)
+			continue;
+		uint i = 0;
+		while (i < length && stored->text[i] == name[i])
+			++i;
+		if (i == length)
+			return stored;
+	}
+	return NULL;
+}
+/*----------------------------------------------------------------------------*/
+bool DirEntry::grow()
+{
+	const uint count = m_bucketCount ? m_bucketCount * 2 : MIN_BUCKETS;
+	Name** buckets = (Name**)malloc( count * sizeof(Name*) );
+	if (!buckets)
+		return false;
+
+	for (uint i = 0; i < count; ++i)
+		buckets[i] = NULL;
+	for (Name* name = m_first; name; name = name->next) {
+		Name*& bucket = buckets[name->hash & (count - 1)];
+		name->chain = bucket;
+		bucket = name;
+	}
+
+	PRINT_DEBUG ("Hash of %u names grown to %u buckets.\n", m_count, count);
+	free( m_buckets );
+	m_buckets = buckets;
+	m_bucketCount = count;
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+bool DirEntry::addSubEntry( const char* name, uint length, Entry* entry )
 {
-	String str( name );
-	PRINT_DEBUG ("Adding SubEntry %s.\n", str.cstr() );
-	m_subEntries.insert( NamePair(str, entry) );
-	if  ( m_opencount == 0)
-		m_nextEntry = m_subEntries.min();
+	if (!length || find( name, length ))
+		return false;
+
+	if (m_count >= m_bucketCount * 2 && !grow() && !m_bucketCount)
+		return false;
+
+	Name* stored = (Name*)malloc( sizeof(Name) + length );
+	if (!stored)
+		return false;
+
+	for (uint i = 0; i < length; ++i)
+		stored->text[i] = name[i];
+	stored->text[length] = '\0';
+	stored->length = length;
+	stored->hash   = hash( name, length );
+	stored->entry  = entry;
+	stored->next   = NULL;
+
+	Name*& bucket = m_buckets[stored->hash & (m_bucketCount - 1)];
+	stored->chain = bucket;
+	bucket = stored;
+
+	if (m_last)
+		m_last->next = stored;
+	else
+		m_first = stored;
+	m_last = stored;
+	++m_count;
+
+	PRINT_DEBUG ("Added SubEntry %s.\n", stored->text);
+	if (!m_nextEntry && m_opencount == 0)
+		m_nextEntry = m_first;
 	return true;
 }
 /*----------------------------------------------------------------------------*/
+bool DirEntry::addSubEntry( const char* name, Entry* entry )
+{
+	uint length = 0;
+	while (name[length])
+		++length;
+	return addSubEntry( name, length, entry );
+}
+/*----------------------------------------------------------------------------*/
 const String DirEntry::firstEntry()
 {
-	PRINT_DEBUG("asked for the first entry.\n");
-	String ret;
-	if (m_subEntries.count()) {
-		 ret = m_subEntries.min()->data().first;
-		 PRINT_DEBUG ("There should be an answer,\n");
-	}
-	ASSERT(m_subEntries.checkOK());
-	PRINT_DEBUG ("Asked for the first entry got: \"%s\".\n",ret.cstr()?ret.cstr():"EMPTY");
-	return ret;
+	PRINT_DEBUG ("Asked for the first entry got: \"%s\".\n",
+		m_first ? m_first->text : "EMPTY");
+	return String( m_first ? m_first->text : NULL );
 }
 /*----------------------------------------------------------------------------*/
 const String DirEntry::nextEntry( const String& previous )
 {
-	SplayBinaryNode<NamePair> * entry =
-		m_subEntries.findItem( NamePair( previous, NULL ) );
-	ASSERT (m_subEntries.checkOK());
+	const Name* entry =
+		previous.empty() ? NULL : find( previous.cstr(), previous.size() );
 	String ret;
-	if (entry && entry->next()) {
-		ret = entry->next()->data().first;
+	if (entry && entry->next) {
+		ret = entry->next->text;
 	}
 	PRINT_DEBUG ("Asked for entry following \"%s\" got \"%s\".\n",
 		previous.cstr(), ret.cstr()?ret.cstr():"EMPTY");
 	return ret;
 }
 /*----------------------------------------------------------------------------*/
-Entry* DirEntry::subEntry( const String& name )
+Entry* DirEntry::subEntry( const char* name, uint length )
 {
-	SplayBinaryNode<NamePair> * entry =
-		m_subEntries.findItem( NamePair( name, NULL ) );
-	PRINT_DEBUG ("Found subentry: %s at ptr %p.\n", name.cstr(), entry);
-	return entry ? entry->data().second : NULL;
+	const Name* entry = find( name, length );
+	PRINT_DEBUG ("Found subentry of length %u at ptr %p.\n", length, entry);
+	return entry ? entry->entry : NULL;
 }
 /*----------------------------------------------------------------------------*/
 uint DirEntry::seek( FilePos pos, int offset )
 {
-	if (m_subEntries.count() == 0)
+	if (m_count == 0)
 		return 0;
 	switch (pos) {
 		case POS_CURRENT:
 		case POS_START:
-			m_nextEntry = m_subEntries.min(); 
-			ASSERT(m_nextEntry);
-			if (offset < 0 || (uint)offset > m_subEntries.count())
+			m_nextEntry = m_first;
+			if (offset < 0 || (uint)offset > m_count)
 				return 0;
 			for (int i = 0; i < offset; ++i) {
 				ASSERT(m_nextEntry);
-				m_nextEntry = m_nextEntry->next();
+				m_nextEntry = m_nextEntry->next;
 			}
 			return offset;
 		case POS_END:
-			m_nextEntry = m_subEntries.max();
-			ASSERT(m_nextEntry);
-			if (offset > 0 || (uint)-offset > m_subEntries.count())
-				return m_subEntries.count();
-			for (int i = 0; i < offset; ++i) {
+			/* names are linked forward only, count from the start */
+			if (offset > 0 || (uint)-offset > m_count) {
+				m_nextEntry = NULL;
+				return m_count;
+			}
+			m_nextEntry = m_first;
+			for (uint i = 0; i < m_count + offset; ++i) {
 				ASSERT(m_nextEntry);
-				m_nextEntry = m_nextEntry->previous();
+				m_nextEntry = m_nextEntry->next;
 			}
-			return m_subEntries.count() - offset;
+			return m_count + offset;
 	}
-	m_nextEntry = m_subEntries.min();
+	m_nextEntry = m_first;
 	return 0;
 }
 /*----------------------------------------------------------------------------*/
@@ -127,7 +207,17 @@ const Pair<String, Entry*> DirEntry::nextEntry()
 	if (!m_nextEntry)
 		return Pair<String, Entry*>("", NULL);
 	
-	Pair<String, Entry*> ret =  m_nextEntry->data();
-	m_nextEntry = m_nextEntry->next();
+	Pair<String, Entry*> ret( m_nextEntry->text, m_nextEntry->entry );
+	m_nextEntry = m_nextEntry->next;
 	return ret;
 }
+/*----------------------------------------------------------------------------*/
+DirEntry::~DirEntry()
+{
+	while (m_first) {
+		Name* name = m_first;
+		m_first = name->next;
+		free( name );
+	}
+	free( m_buckets );
+}
@@ -27,29 +27,24 @@
  * @file 
  * @brief DirEntry class declaration.
  *
- * Long description. I would paste some Loren Ipsum rubbish here, but I'm afraid
- * It would stay that way. Not that this comment is by any means ingenious but 
- * at least people can understand it. 
+ * Directory keeps its entries in a hash table of names, so lookups take
+ * the same time no matter how many files the directory holds.
  */
 
 #pragma once
 #include "Entry.h"
 #include "String.h"
 #include "structures/Pair.h"
-#include "structures/Trees.h"
-
-template class Pair<String, Entry*>;
-template class Tree< SplayBinaryNode<Pair<String, Entry*> > >;
-
-typedef Pair<String, Entry*> NamePair;
-typedef Trees<NamePair>::SplayTree EntryList;
 
 /*!
  * @class DirEntry DirEntry.h "tarfs/DirEntry.h"
  * @brief Class representing directory on TarFs.
  *
- * Class stores Pairs identifying names of the directory Entries with
- * their respective Entries. This map is stored in the SplayTree.
+ * Class maps names of the directory Entries to their respective Entries.
+ * Every name is stored once, together with its hash and length, in a hash
+ * table that doubles when it gets more than two names per bucket.
+ * Names are also linked in the order they were added (archive order),
+ * listing follows this order.
  */
 class DirEntry: public Entry
 {
@@ -57,19 +52,27 @@ public:
 	/*!
 	 * @brief No device to store Direntry data on.
 	 */
-	DirEntry(DiskDevice* storage = NULL):Entry( storage ), m_opencount( 0 ),
-		m_nextEntry( NULL )
-		{};
+	DirEntry(DiskDevice* storage = NULL);
+
+	/*!
+	 * @brief Adds name->Entry maping coresponding to the item in this dir.
+	 * @param name Name of the Entry, it is copied.
+	 * @param length Length of the name.
+	 * @param entry The Entry.
+	 * @return @a true if Entry was sucessfully added, @a false otherwise.
+	 */
+	bool addSubEntry( const char* name, uint length, Entry* entry );
 
 	/*!
 	 * @brief Adds name->Entry maping coresponding to the item in this dir.
+	 * @param name Zero terminated name of the Entry, it is copied.
+	 * @param entry The Entry.
 	 * @return @a true if Entry was sucessfully added, @a false otherwise.
 	 */
-	bool addSubEntry( char* name, Entry* entry );
+	bool addSubEntry( const char* name, Entry* entry );
 
 	/*!
-	 * @brief Gets the name of the first Entry in this directory,
-	 * 	in alphanumeric order.
+	 * @brief Gets the name of the first Entry in this directory.
 	 * @return Name of the first Entry.
 	 */
 	const String firstEntry();
@@ -88,7 +91,16 @@ public:
 	 * @param name Name of the Entry.
 	 * @return Ptr to the corresponding entry, NULL on failure.
 	 */
-	Entry* subEntry( const String& name );
+	Entry* subEntry( const String& name )
+		{ return name.empty() ? NULL : subEntry( name.cstr(), name.size() ); };
+
+	/*!
+	 * @brief Translates Name into the Entry*.
+	 * @param name Name of the Entry (need not be zero terminated).
+	 * @param length Length of the name.
+	 * @return Ptr to the corresponding entry, NULL on failure.
+	 */
+	Entry* subEntry( const char* name, uint length );
 
 	/*!
 	 * @brief Converts self to DirEntry pointer.
@@ -100,7 +112,7 @@ public:
 	 * @brief Gets the number of Entries in this directory.
 	 * @return Number of Entries.
 	 */
-	size_t size() const { return m_subEntries.count(); };
+	size_t size() const { return m_count; };
 
 	/*!
 	 * @brief Fails the reading operation as directories cannot be read
@@ -136,12 +148,59 @@ public:
 	void close() 
 	{ 
 		if (m_opencount) --m_opencount; 
-		if (!m_opencount) m_nextEntry = m_subEntries.min();
+		if (!m_opencount) m_nextEntry = m_first;
 	};
 
+	/*! @brief Frees the names, Entries are not deleted. */
+	~DirEntry();
+
 private:
-	EntryList m_subEntries;  /*!< List of stored Entries. */
+	/*! @brief Initial number of hash buckets. */
+	static const uint MIN_BUCKETS = 8;
+
+	/*! @brief Name of one Entry, allocated with the text. */
+	struct Name {
+		Entry* entry;         /*!< Named Entry.                       */
+		uint hash;            /*!< Hash of the text.                  */
+		uint length;          /*!< Length of the text.                */
+		Name* chain;          /*!< Next name in the same bucket.      */
+		Name* next;           /*!< Next name in the directory order.  */
+		char text[1];         /*!< Zero terminated text.              */
+	};
+
+	Name** m_buckets;        /*!< Hash table of names.                */
+	uint m_bucketCount;      /*!< Number of buckets (power of 2).     */
+	uint m_count;            /*!< Number of names.                    */
+	Name* m_first;           /*!< First added name.                   */
+	Name* m_last;            /*!< Last added name.                    */
 	uint m_opencount;        /*!< Count of open calls - close calls.*/
+	Name* m_nextEntry;       /*!< Position wihtin directory.          */
+
+	/*!
+	 * @brief Computes hash of the name.
+	 * @param name The name.
+	 * @param length Length of the name.
+	 * @return FNV-1a hash of the name.
+	 */
+	static uint hash( const char* name, uint length );
+
+	/*!
+	 * @brief Finds the name in the hash table.
+	 * @param name The name.
+	 * @param length Length of the name.
+	 * @return Stored name, NULL if there is none.
+	 */
+	Name* find( const char* name, uint length ) const;
+
+	/*!
+	 * @brief Doubles the number of buckets.
+	 * @return @a True on success, @a false if there is no memory.
+	 */
+	bool grow();
+
+	/*! No copying */
+	DirEntry( const DirEntry& );
 
-	/*! Position wihtin directory. */
-	BinaryNode<Pair<String, Entry*> >* m_nextEntry; };
+	/*! No assigning */
+	DirEntry& operator = ( const DirEntry& );
+};
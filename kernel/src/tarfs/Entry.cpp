@@ -41,3 +41,21 @@ bool Entry::readFromDevice(void* buffer, size_t count, uint start_block, uint of
 	ASSERT (m_storage);
 	return m_storage->read(buffer, count, start_block, offset);
 }
+/*----------------------------------------------------------------------------*/
+bool Entry::writeToDevice(const void* buffer, size_t count, uint start_block, uint offset)
+{
+	ASSERT (m_storage);
+	return m_storage->write((void*)buffer, count, start_block, offset);
+}
+/*----------------------------------------------------------------------------*/
+void Entry::prefetchFromDevice(uint block, uint count)
+{
+	ASSERT (m_storage);
+	m_storage->prefetch(block, count);
+}
+/*----------------------------------------------------------------------------*/
+bool Entry::flushDevice()
+{
+	ASSERT (m_storage);
+	return m_storage->flush();
+}
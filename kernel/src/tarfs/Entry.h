@@ -112,6 +112,21 @@ protected:
 	 * @brief Provides read interface for the devices this Entry is stored on.
 	 */
 	bool readFromDevice(void* buffer, size_t count, uint start_block, uint offset);
+
+	/*!
+	 * @brief Provides write interface for the devices this Entry is stored on.
+	 */
+	bool writeToDevice(const void* buffer, size_t count, uint start_block, uint offset);
+
+	/*!
+	 * @brief Asks the device to read the blocks in the background.
+	 */
+	void prefetchFromDevice(uint block, uint count);
+
+	/*!
+	 * @brief Makes the device write all cached data to the disk.
+	 */
+	bool flushDevice();
 private:
 	DiskDevice* m_storage; /*!< Storage where the data of this Entry are stored.*/
 };
@@ -33,6 +33,9 @@
  */
 
 #include "FileEntry.h"
+#include "api.h"
+#include "tools.h"
+#include "drivers/DiskDevice.h"
 
 //#define ENTRY_DEBUG
 
@@ -46,7 +49,7 @@
 
 
 FileEntry::FileEntry( TarHeader& header, uint start_block, DiskDevice* disk ):
-	Entry( disk )
+	Entry( disk ), m_readCount( 0 ), m_appendLimit( 0 )
 {
 	m_size = header.fileSize();
 	m_startPos = start_block + 1;
@@ -54,7 +57,8 @@ FileEntry::FileEntry( TarHeader& header, uint start_block, DiskDevice* disk ):
 /*----------------------------------------------------------------------------*/
 bool FileEntry::open( const char mode )
 {
-	if ( (mode & OPEN_W) || (mode & OPEN_A) ) return false;
+	if (mode & OPEN_W) return false;
+	if ((mode & OPEN_A) && !m_appendLimit) return false;
 	++m_readCount;
 	return true;
 }
@@ -63,35 +67,128 @@ void FileEntry::close()
 {
 	ASSERT (m_readCount);
 	--m_readCount;
-	if (!m_readCount) m_pos = 0;
+	if (!m_readCount) m_cursor = Cursor();
 }
 /*----------------------------------------------------------------------------*/
-ssize_t FileEntry::read( void* buffer, int size )
+ssize_t FileEntry::read( void* buffer, size_t size, Cursor& cursor )
 {
-	if (size < 0 || (m_pos + size) > m_size) return EIO;
-	bool res = readFromDevice( buffer, size, m_startPos, m_pos);
+	size = min<size_t>( size, m_size - cursor.pos );
+	if (!size) return 0;
+
+	const uint pos = cursor.pos;
+	bool res = readFromDevice( buffer, size, m_startPos, pos );
 	PRINT_DEBUG("Reading from Entry to buffer %p(%u): %s\n", 
 		buffer, size, res ? "OK": "FAIL" );
+	if (!res) return EIO;
+
+	cursor.pos = pos + size;
+	readAhead( pos, size, cursor );
+	return size;
+}
+/*----------------------------------------------------------------------------*/
+ssize_t FileEntry::readv( const IOVEC* iov, uint count, Cursor& cursor )
+{
+	const uint start = cursor.pos;
+	uint pos = start;
+
+	for (uint i = 0; i < count && pos < m_size; ++i) {
+		const size_t size = min<size_t>( iov[i].len, m_size - pos );
+		if (!size) continue;
+		if (!readFromDevice( iov[i].base, size, m_startPos, pos ))
+			return EIO;
+		PRINT_DEBUG("Read %u bytes at %u to %p.\n", size, pos, iov[i].base);
+		pos += size;
+	}
 
-	return res ? size : EIO;
+	cursor.pos = pos;
+	if (pos > start)
+		readAhead( start, pos - start, cursor );
+	return pos - start;
+}
+/*----------------------------------------------------------------------------*/
+void FileEntry::readAhead( uint pos, uint size, Cursor& cursor )
+{
+	if (pos != cursor.streamPos || !pos) {
+		/* random access (or a new stream), read-ahead is wasted */
+		cursor.window   = pos ? 0 : READ_AHEAD_MIN;
+		cursor.aheadEnd = 0;
+	} else {
+		cursor.window = cursor.window
+			? min( cursor.window * 2, READ_AHEAD_MAX ) : READ_AHEAD_MIN;
+	}
+	cursor.streamPos = pos + size;
+
+	const uint file_blocks = roundUp( m_size, BLOCK_SIZE ) / BLOCK_SIZE;
+	const uint next = roundUp( cursor.streamPos, BLOCK_SIZE ) / BLOCK_SIZE;
+	const uint from = max( next, cursor.aheadEnd );
+	const uint to   = min( next + cursor.window, file_blocks );
+
+	if (!cursor.window || from >= to)
+		return;
+
+	PRINT_DEBUG ("Reading ahead blocks %u-%u (window %u).\n", from, to, cursor.window);
+	prefetchFromDevice( m_startPos + from, to - from );
+	cursor.aheadEnd = to;
+}
+/*----------------------------------------------------------------------------*/
+ssize_t FileEntry::readAt( void* buffer, size_t size, uint pos )
+{
+	if (pos > m_size || size > (m_size - pos)) return EIO;
+	bool res = readFromDevice( buffer, size, m_startPos, pos );
+	PRINT_DEBUG("Reading from Entry at %u to buffer %p(%u): %s\n",
+		pos, buffer, size, res ? "OK": "FAIL" );
+
+	return res ? (ssize_t)size : (ssize_t)EIO;
+}
+/*----------------------------------------------------------------------------*/
+ssize_t FileEntry::append( const void* buffer, size_t size )
+{
+	if (!size) return 0;
+
+	m_appendGuard.lock();
+	if (size > m_appendLimit - m_size) {
+		m_appendGuard.unlock();
+		return ENOSPC;
+	}
+
+	/* data first, the header makes them part of the file */
+	TarHeader header;
+	bool res = writeToDevice( buffer, size, m_startPos, m_size )
+		&& readFromDevice( &header, sizeof(header), m_startPos - 1, 0 );
+	if (res) {
+		header.setFileSize( m_size + size );
+		res = writeToDevice( &header, sizeof(header), m_startPos - 1, 0 );
+	}
+	PRINT_DEBUG ("Appending %u bytes at %u: %s.\n",
+		size, m_size, res ? "OK" : "FAIL");
+	if (res)
+		m_size += size;
+	m_appendGuard.unlock();
+
+	return res ? (ssize_t)size : (ssize_t)EIO;
+}
+/*----------------------------------------------------------------------------*/
+int FileEntry::sync()
+{
+	return flushDevice() ? EOK : EIO;
 }
 /*----------------------------------------------------------------------------*/
-uint FileEntry::seek( FilePos pos, int offset )
+uint FileEntry::seek( FilePos pos, int offset, Cursor& cursor )
 {
 	PRINT_DEBUG ("Seeking pos: %u, offset %u.\n", pos, offset);
 	switch (pos) {
 		case POS_START:
-			if (offset >= 0 && (uint)offset < m_size) m_pos = offset;
+			if (offset >= 0 && (uint)offset < m_size) cursor.pos = offset;
 			break;
 		case POS_CURRENT:
-			if (offset > 0 && (m_pos + offset) < m_size) m_pos += offset;
-			if (offset < 0 && (m_pos >= (uint)-offset))  m_pos -= offset;
+			if (offset > 0 && (cursor.pos + offset) < m_size) cursor.pos += offset;
+			if (offset < 0 && (cursor.pos >= (uint)-offset))  cursor.pos -= offset;
 			break;
 		case POS_END:
-			if (offset <= 0 && (m_size  > (uint)-offset)) m_pos = m_size + offset;
+			if (offset <= 0 && (m_size  > (uint)-offset)) cursor.pos = m_size + offset;
 	}
-	PRINT_DEBUG ("Result: %u.\n", m_pos);
-	return m_pos;
+	PRINT_DEBUG ("Result: %u.\n", cursor.pos);
+	return cursor.pos;
 }
 /*----------------------------------------------------------------------------*/
 FileEntry::~FileEntry()
@@ -35,6 +35,8 @@
 #pragma once
 #include "TarHeader.h"
 #include "Entry.h"
+#include "iovec.h"
+#include "synchronization/Mutex.h"
 
 class DiskDevice;
 
@@ -42,12 +44,40 @@ class DiskDevice;
  * @class FileEntry FileEntry.h "tarfs/FileEntry.h"
  * @brief Class represents files stored on the TarFS.
  *
- * Class provides basic RO interface for accessing files.
+ * Class provides basic RO interface for accessing files. The last file
+ * of the archive may be opened for appending (see setAppendLimit()),
+ * it grows into the free space following the archive.
+ *
+ * Sequential reading is detected, blocks following the read data are then
+ * prefetched by the device. The read-ahead window starts at READ_AHEAD_MIN
+ * blocks and doubles with every sequential read up to READ_AHEAD_MAX,
+ * any other access resets it.
+ *
+ * Position and read-ahead state are kept in a Cursor, every opened file
+ * descriptor has its own (see OpenFile). The Entry interface (read(),
+ * seek()) uses a cursor shared by all its users.
  */
 
 class FileEntry: public Entry
 {
 public:
+	/*! @brief Read-ahead window after the first sequential read (blocks). */
+	static const uint READ_AHEAD_MIN = 4;
+
+	/*! @brief Largest read-ahead window (blocks). */
+	static const uint READ_AHEAD_MAX = 64;
+
+	/*! @brief Position and read-ahead state of one reader. */
+	struct Cursor {
+		uint pos;        /*!< Current position in the file.          */
+		uint streamPos;  /*!< Where the next sequential read starts. */
+		uint window;     /*!< Read-ahead window (blocks), 0 if none. */
+		uint aheadEnd;   /*!< First block that was not prefetched.   */
+
+		/*! @brief Cursor at the start of the file. */
+		Cursor(): pos( 0 ), streamPos( 0 ), window( 0 ), aheadEnd( 0 ) {};
+	};
+
 	/*!
 	 * @brief Creates FileEntry using data from TarHeader, stored on the disk.
 	 * @param tarHeader Header of the file as it is stored on the disk.
@@ -67,9 +97,70 @@ public:
 	 * @param size Number of bytes to read.
 	 * @return Number of bytes read, negative number indicates error.
 	 *
-	 * Data are read from the current posiont in the file
+	 * Data are read from the current posiont in the file, the position
+	 * is moved past the read data. Less than @a size bytes are read at
+	 * the end of the file.
+	 */
+	ssize_t read( void* buffer, int size )
+		{ return (size < 0) ? (ssize_t)EIO : read( buffer, (size_t)size, m_cursor ); };
+
+	/*!
+	 * @brief Reads data from the position of the cursor.
+	 * @param buffer Place to store the read data.
+	 * @param size Number of bytes to read.
+	 * @param cursor Position to read from, it is moved past the read data.
+	 * @return Number of bytes read, negative number indicates error.
+	 */
+	ssize_t read( void* buffer, size_t size, Cursor& cursor );
+
+	/*!
+	 * @brief Reads consecutive data into several buffers.
+	 * @param iov Buffers to fill, in order.
+	 * @param count Number of buffers.
+	 * @param cursor Position to read from, it is moved past the read data.
+	 * @return Number of bytes read, negative number indicates error.
+	 *
+	 * Buffers are filled as if it was one read, data following the last
+	 * one are read ahead only once.
 	 */
-	ssize_t read( void* buffer, int size );
+	ssize_t readv( const IOVEC* iov, uint count, Cursor& cursor );
+
+	/*!
+	 * @brief Reads data from the given position, current position is
+	 * 	not used nor changed.
+	 * @param buffer Place to store the read data.
+	 * @param size Number of bytes to read.
+	 * @param pos Offset of the first byte to read.
+	 * @return Number of bytes read, negative number indicates error.
+	 */
+	ssize_t readAt( void* buffer, size_t size, uint pos );
+
+	/*!
+	 * @brief Appends data to the end of the file.
+	 * @param buffer Data to append.
+	 * @param size Number of bytes to append.
+	 * @return Number of bytes written, negative number indicates error
+	 * 	(ENOSPC if the file would grow over its append limit).
+	 *
+	 * Data and the updated header are written through the disk cache,
+	 * use sync() to make sure they reached the disk.
+	 */
+	ssize_t append( const void* buffer, size_t size );
+
+	/*!
+	 * @brief Writes all appended data to the disk.
+	 * @return EOK on success, EIO otherwise.
+	 */
+	int sync();
+
+	/*!
+	 * @brief Allows appending to the file.
+	 * @param limit Maximum size of the file, 0 disables appending.
+	 */
+	inline void setAppendLimit( uint limit ) { m_appendLimit = limit; };
+
+	/*! @brief Gets size of the file data. */
+	inline uint size() const { return m_size; };
 
 	/*!
 	 * @brief Changes current posiont in the file.
@@ -77,7 +168,17 @@ public:
 	 * @param offset New position as offset from the reference.
 	 * @return New position in the file.
 	 */
-	uint seek( FilePos pos, int offset );
+	uint seek( FilePos pos, int offset )
+		{ return seek( pos, offset, m_cursor ); };
+
+	/*!
+	 * @brief Moves the cursor.
+	 * @param pos Point of reference (start, current, end).
+	 * @param offset New position as offset from the reference.
+	 * @param cursor The cursor.
+	 * @return New position in the file.
+	 */
+	uint seek( FilePos pos, int offset, Cursor& cursor );
 
 	/*!
 	 * @brief Opens file using @a mode.
@@ -99,7 +200,17 @@ private:
 	uint m_startPos;   /*!< First data block.                      */
 	uint m_modTime;    /*!< Time of the last modifications. UNUSED */
 	uint m_readCount;  /*!< Number of openings or reading.         */
-	uint m_pos;        /*!< Current position in the file.          */
+	uint m_appendLimit;/*!< Maximum size, 0 if appending is denied. */
+	Mutex m_appendGuard;/*!< Serializes appends.                   */
+	Cursor m_cursor;   /*!< Position used by the Entry interface.  */
+
+	/*!
+	 * @brief Updates sequential access detection and starts read-ahead.
+	 * @param pos Position of the read.
+	 * @param size Number of bytes read.
+	 * @param cursor Read-ahead state to update.
+	 */
+	void readAhead( uint pos, uint size, Cursor& cursor );
 		
 	FileEntry( const FileEntry& );              /*!< No copies.      */
 	FileEntry& operator = ( const FileEntry& ); /*!< No assignments. */
@@ -0,0 +1,79 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Class OpenFile implementation.
+ */
+
+#include "OpenFile.h"
+#include "api.h"
+#include "tools.h"
+
+/*----------------------------------------------------------------------------*/
+ssize_t OpenFile::read( void* buffer, size_t size )
+{
+	if (!file())
+		return m_entry->read( buffer, size );
+	return file()->read( buffer, size, m_cursor );
+}
+/*----------------------------------------------------------------------------*/
+ssize_t OpenFile::pread( void* buffer, size_t size, uint pos )
+{
+	if (!file())
+		return EIO;
+	if (pos >= file()->size())
+		return 0;
+	return file()->readAt( buffer, min<size_t>( size, file()->size() - pos ), pos );
+}
+/*----------------------------------------------------------------------------*/
+ssize_t OpenFile::readv( const IOVEC* iov, uint count )
+{
+	if (!file())
+		return EIO;
+	return file()->readv( iov, count, m_cursor );
+}
+/*----------------------------------------------------------------------------*/
+ssize_t OpenFile::write( const void* buffer, size_t size )
+{
+	if (!file() || !(m_mode & OPEN_A))
+		return EINVAL;
+	return file()->append( buffer, size );
+}
+/*----------------------------------------------------------------------------*/
+int OpenFile::sync()
+{
+	if (!file())
+		return EINVAL;
+	return file()->sync();
+}
+/*----------------------------------------------------------------------------*/
+uint OpenFile::seek( FilePos pos, int offset )
+{
+	if (!file())
+		return m_entry->seek( pos, offset );
+	return file()->seek( pos, offset, m_cursor );
+}
+/*----------------------------------------------------------------------------*/
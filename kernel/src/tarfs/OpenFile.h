@@ -0,0 +1,113 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Class OpenFile declaration.
+ */
+
+#pragma once
+#include "FileEntry.h"
+
+/*!
+ * @class OpenFile OpenFile.h "tarfs/OpenFile.h"
+ * @brief Opened file descriptor, stored in the file table of the process.
+ *
+ * Every descriptor has its own position and read-ahead state, so readers
+ * of the same file do not disturb each other. Directories keep using
+ * the state of their Entry.
+ */
+class OpenFile
+{
+public:
+	/*!
+	 * @brief Creates descriptor of the opened entry.
+	 * @param entry Opened entry, descriptor does not open nor close it.
+	 * @param mode Mode the entry was opened with.
+	 */
+	OpenFile( Entry* entry, char mode ): m_entry( entry ), m_mode( mode ) {};
+
+	/*! @brief Gets the opened entry. */
+	inline Entry* entry() const { return m_entry; };
+
+	/*! @brief Gets the opened file, NULL for directories. */
+	inline FileEntry* file() const { return m_entry->fileEntry(); };
+
+	/*!
+	 * @brief Reads from the current position, position is moved.
+	 * @param buffer Place to store the data.
+	 * @param size Number of bytes to read.
+	 * @return Number of bytes read, negative number indicates error.
+	 */
+	ssize_t read( void* buffer, size_t size );
+
+	/*!
+	 * @brief Reads from the given position, current position is kept.
+	 * @param buffer Place to store the data.
+	 * @param size Number of bytes to read.
+	 * @param pos Position of the first byte.
+	 * @return Number of bytes read (less at the end of the file),
+	 * 	negative number indicates error.
+	 */
+	ssize_t pread( void* buffer, size_t size, uint pos );
+
+	/*!
+	 * @brief Fills the buffers from the current position, position is moved.
+	 * @param iov Buffers to fill.
+	 * @param count Number of buffers.
+	 * @return Number of bytes read, negative number indicates error.
+	 */
+	ssize_t readv( const IOVEC* iov, uint count );
+
+	/*!
+	 * @brief Appends data to the file, it has to be opened with OPEN_A.
+	 * @param buffer Data to write.
+	 * @param size Number of bytes to write.
+	 * @return Number of bytes written, negative number indicates error.
+	 */
+	ssize_t write( const void* buffer, size_t size );
+
+	/*!
+	 * @brief Writes cached data of the file to the disk.
+	 * @return EOK on success, error code otherwise.
+	 */
+	int sync();
+
+	/*!
+	 * @brief Changes the current position.
+	 * @param pos Point of reference (start, current, end).
+	 * @param offset New position as offset from the reference.
+	 * @return New position.
+	 */
+	uint seek( FilePos pos, int offset );
+
+private:
+	Entry* m_entry;              /*!< Opened entry.                    */
+	char m_mode;                 /*!< Open mode.                       */
+	FileEntry::Cursor m_cursor;  /*!< Position in the file.            */
+
+	OpenFile( const OpenFile& );              /*!< No copies.      */
+	OpenFile& operator = ( const OpenFile& ); /*!< No assignments. */
+};
@@ -52,9 +52,12 @@
 
 #define TAR_BLOCK_SIZE (sizeof(TarHeader))
 #define SIGNED_BITS_MASK (0x7fffffff)
-#define DIR_SELF (char*)"."
+#define DIR_SELF "."
+#define DIR_PARENT ".."
 
-TarFS::TarFS( DiskDevice* disk )
+TarFS::TarFS( DiskDevice* disk ):
+	m_mountedDisk( NULL ), m_scanBlock( 0 ), m_scanned( false ),
+	m_lastFile( NULL )
 {
 	PRINT_DEBUG ("Creating tarfs on disk %p...\n", disk);
 	mount( disk );
@@ -65,36 +68,166 @@ bool TarFS::mount( DiskDevice* disk )
 
 	if (!disk || !disk->size()) return false;
 
+	/* headers are read on the first lookups, see getFile() */
 	m_mountedDisk = disk;
-	TarHeader header;
-	uint block = 0;
+	m_scanBlock = 0;
+	m_scanned = false;
+	m_lastFile = NULL;
 
 	PRINT_DEBUG ("Mounting device %p of size %u B.\n", disk, disk->size());
 	m_rootDir.addSubEntry( DIR_SELF, &m_rootDir );
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+Entry* TarFS::getFile( const char file_name[] )
+{
+	m_guard.lock();
 
-	while (disk->read( &header, TAR_BLOCK_SIZE, block, 0 )) {
-		/* if there is no name it might only be the end*/
-		if (header.fileName()[0] == '\0') break;
+	/* index headers until the file shows up */
+	Entry* entry;
+	while (!(entry = lookup( file_name )) && scanNext());
 
-		if (header.fileType() == TarHeader::File) {
-				PRINT_DEBUG ("Found file: %s (%d).\n", header.fileName(), header.fileSize() );
-				FileEntry* file = new FileEntry( header, block, disk );
-				m_rootDir.addSubEntry( header.fileName(), file );
+	if (entry && entry->dirEntry()) {
+		/* listing needs all entries of the directory */
+		scanAll();
+	} else if (entry && !m_scanned) {
+		/* the next header tells whether the file is the last one */
+		scanNext();
+	}
+
+	m_guard.unlock();
+	PRINT_DEBUG ("Looked up %s: %p.\n", file_name, entry);
+	return entry;
+}
+/*----------------------------------------------------------------------------*/
+DirEntry* TarFS::rootDir()
+{
+	m_guard.lock();
+	scanAll();
+	m_guard.unlock();
+	return &m_rootDir;
+}
+/*----------------------------------------------------------------------------*/
+Entry* TarFS::lookup( const char* path )
+{
+	Entry* entry = &m_rootDir;
+	while (*path) {
+		if (*path == '/') {
+			++path;
+			continue;
+		}
+		uint length = 0;
+		while (path[length] && path[length] != '/')
+			++length;
+
+		DirEntry* dir = entry->dirEntry();
+		if (!dir || !(entry = dir->subEntry( path, length )))
+			return NULL;
+		path += length;
+	}
+	return entry;
+}
+/*----------------------------------------------------------------------------*/
+DirEntry* TarFS::directory( const char* path, uint length )
+{
+	DirEntry* dir = &m_rootDir;
+	uint pos = 0;
+	while (pos < length) {
+		if (path[pos] == '/') {
+			++pos;
+			continue;
 		}
+		uint end = pos;
+		while (end < length && path[end] != '/')
+			++end;
 
-		block += roundUp(header.fileSize(), TAR_BLOCK_SIZE) / TAR_BLOCK_SIZE + 1;
+		/* directories missing in the archive are created */
+		Entry* entry = dir->subEntry( path + pos, end - pos );
+		if (!entry) {
+			DirEntry* sub = new DirEntry( m_mountedDisk );
+			if (!sub)
+				return NULL;
+			sub->addSubEntry( DIR_SELF, sub );
+			sub->addSubEntry( DIR_PARENT, dir );
+			dir->addSubEntry( path + pos, end - pos, sub );
+			PRINT_DEBUG ("Created directory at block %u.\n", m_scanBlock);
+			entry = sub;
+		}
+		if (!(dir = entry->dirEntry()))
+			return NULL;
+		pos = end;
+	}
+	return dir;
+}
+/*----------------------------------------------------------------------------*/
+bool TarFS::scanNext()
+{
+	if (m_scanned)
+		return false;
 
-		PRINT_DEBUG ("Next Block: %d.\n", block);
+	TarHeader header;
+	/* if there is no name it might only be the end*/
+	if (!m_mountedDisk->read( &header, TAR_BLOCK_SIZE, m_scanBlock, 0 )
+		|| header.fileName()[0] == '\0') {
+		finishScan();
+		return false;
 	}
-#ifdef TARFS_DEBUG
-	PRINT_DEBUG ("Mount end.\n");
-	PRINT_DEBUG ("Mounted:\n");
-	String str = m_rootDir.firstEntry();
-	while (!str.empty()) {
-			PRINT_DEBUG ("%s\n", str.cstr());
-			str =  m_rootDir.nextEntry( str );
+
+	const uint block = m_scanBlock;
+	m_scanBlock += roundUp( header.fileSize(), TAR_BLOCK_SIZE ) / TAR_BLOCK_SIZE + 1;
+	PRINT_DEBUG ("Next Block: %d.\n", m_scanBlock);
+
+	/* name need not be terminated, trailing slashes are ignored */
+	const char* name = header.fileName();
+	uint length = 0;
+	while (length < TarHeader::NAME_LENGTH && name[length])
+		++length;
+	while (length && name[length - 1] == '/')
+		--length;
+	uint base = length;
+	while (base && name[base - 1] != '/')
+		--base;
+
+	m_lastFile = NULL;
+	switch (header.fileType()) {
+		case TarHeader::File: {
+			DirEntry* dir = directory( name, base );
+			if (!dir || base == length)
+				break;
+			PRINT_DEBUG ("Found file at block %u (%d).\n", block, header.fileSize());
+			FileEntry* file = new FileEntry( header, block, m_mountedDisk );
+			if (file && dir->addSubEntry( name + base, length - base, file ))
+				m_lastFile = file;
+			else
+				delete file;
+			break;
+		}
+		case TarHeader::Directory:
+			directory( name, length );
+			break;
+		default:
+			break;
 	}
-#endif
 	return true;
 }
 /*----------------------------------------------------------------------------*/
+void TarFS::scanAll()
+{
+	while (scanNext());
+}
+/*----------------------------------------------------------------------------*/
+void TarFS::finishScan()
+{
+	m_scanned = true;
+
+	/* the last file may grow, two empty blocks have to mark the end */
+	const size_t blocks = m_mountedDisk->size() / TAR_BLOCK_SIZE;
+	if (m_lastFile && blocks > m_scanBlock + 2) {
+		const size_t limit = (blocks - 2 - m_scanBlock) * TAR_BLOCK_SIZE
+			+ roundUp( m_lastFile->size(), TAR_BLOCK_SIZE );
+		PRINT_DEBUG ("Last file may grow up to %u B.\n", limit);
+		m_lastFile->setAppendLimit( limit );
+	}
+	PRINT_DEBUG ("Indexed %u blocks.\n", m_scanBlock);
+}
+/*----------------------------------------------------------------------------*/
@@ -27,22 +27,30 @@
  * @file
  * @brief TarFS class declaration.
  *
- * Long description. I would paste some Loren Ipsum rubbish here, but I'm afraid
- * It would stay that way. Not that this comment is by any means ingenious but
- * at least people can understand it.
+ * Archive headers are indexed lazily, mount itself reads nothing.
  */
 
 #pragma once
 
 #include "api.h"
-#include "structures/HashMap.h"
 #include "DirEntry.h"
+#include "synchronization/Mutex.h"
+
+class FileEntry;
 
 /*!
  * @class TarFS TarFS.h "tarfs/TarFS.h"
  * @brief VFS implementation using TAR format.
  *
  * Class provides only RO interface. No write, no unmount, no create, ...
+ * Only the last file of the archive may be appended to.
+ *
+ * Headers are read on demand: lookup of a name that is not indexed yet
+ * reads following headers until the name shows up, so opening files at
+ * the start of a large archive does not wait for the rest of it. Whole
+ * archive is indexed when a directory is listed or a name is not found.
+ * Directories (including those only present in paths) form a tree,
+ * each of them hashes names of its entries.
  */
 class TarFS
 {
@@ -68,12 +76,42 @@ public:
 	Entry* getFile( const char file_name[] );
 
 	/*!
-	 * @brief Gets representation of the root directory.
+	 * @brief Gets representation of the root directory, with all entries.
 	 */
-	DirEntry* rootDir()
-		{ return &m_rootDir; };
+	DirEntry* rootDir();
 
 private:
 	DirEntry m_rootDir;        /*!< Top of the directory tree. */
 	DiskDevice* m_mountedDisk; /*!< DiskDevice beeing used.    */
+	uint m_scanBlock;          /*!< Next header to index.      */
+	bool m_scanned;            /*!< Whole archive is indexed.  */
+	FileEntry* m_lastFile;     /*!< Last indexed file.         */
+	Mutex m_guard;             /*!< Serializes indexing.       */
+
+	/*!
+	 * @brief Finds indexed entry.
+	 * @param path Path from the root directory.
+	 * @return The entry, NULL if it is not indexed (yet).
+	 */
+	Entry* lookup( const char* path );
+
+	/*!
+	 * @brief Gets directory, creates it if it was not indexed.
+	 * @param path Path from the root directory (need not be terminated).
+	 * @param length Length of the path.
+	 * @return The directory, NULL if a file is in the way.
+	 */
+	DirEntry* directory( const char* path, uint length );
+
+	/*!
+	 * @brief Indexes the next header.
+	 * @return @a True if there was one, @a false at the end of the archive.
+	 */
+	bool scanNext();
+
+	/*! @brief Indexes the rest of the archive. */
+	void scanAll();
+
+	/*! @brief Marks archive indexed, allows appending to the last file. */
+	void finishScan();
 };
@@ -51,16 +51,25 @@ public:
 		Unknown, File, HardLink, SymLink, Directory, Character, Block, FIFO
 	};
 	
+	/*! @brief Size of the name field, name need not be terminated. */
+	static const uint NAME_LENGTH = 100;
+
 	/*! @brief Gets file name. */
 	inline char*    fileName() { return m_fileName; };
 
 	/*! @brief Gets size converted from TAR format. */
 	inline uint     fileSize();
 
+	/*!
+	 * @brief Stores the size in TAR format, checksum is updated.
+	 * @param size New size of the file.
+	 */
+	inline void     setFileSize( uint size );
+
 	/*! @brief Gets type of the file. */
 	inline FileType fileType();
 private:
-	char m_fileName[100];
+	char m_fileName[NAME_LENGTH];
 	char m_mode[8];
 	char m_uid[8];
 	char m_gid[8];
@@ -87,6 +96,28 @@ inline uint TarHeader::fileSize()
 	return res;
 }
 /*----------------------------------------------------------------------------*/
+inline void TarHeader::setFileSize( uint size )
+{
+	/* 11 octal digits and terminating zero */
+	for (int i = 10; i >= 0; --i, size /= 8)
+		m_fileSize[i] = '0' + (size % 8);
+	m_fileSize[11] = '\0';
+
+	/* checksum is computed as if the checksum field was filled by spaces */
+	for (uint i = 0; i < sizeof(m_checksum); ++i)
+		m_checksum[i] = ' ';
+	uint sum = 0;
+	const byte* data = (const byte*)this;
+	for (uint i = 0; i < sizeof(TarHeader); ++i)
+		sum += data[i];
+
+	/* 6 octal digits, zero and space */
+	for (int i = 5; i >= 0; --i, sum /= 8)
+		m_checksum[i] = '0' + (sum % 8);
+	m_checksum[6] = '\0';
+	m_checksum[7] = ' ';
+}
+/*----------------------------------------------------------------------------*/
 inline TarHeader::FileType TarHeader::fileType()
 {
 	switch (m_link){
@@ -0,0 +1,355 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *   
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Profiler class implementation.
+ *
+ * Sampling, histogram and symbol lookup in the linker map files.
+ */
+
+#include "Profiler.h"
+#include "Kernel.h"
+#include "InterruptDisabler.h"
+#include "address.h"
+#include "tools.h"
+#include "proc/Thread.h"
+#include "tarfs/TarFS.h"
+#include "tarfs/Entry.h"
+#include "tarfs/FileEntry.h"
+
+//#define PROFILER_DEBUG
+
+#ifndef PROFILER_DEBUG
+#define PRINT_DEBUG(...)
+#else
+#define PRINT_DEBUG(ARGS...) \
+  printf("[ PROFILER_DEBUG ]: "); \
+  printf(ARGS);
+#endif
+
+/*! @brief Map of the kernel on the root filesystem. */
+static const char* KERNEL_MAP = "kernel.map";
+
+/*! @brief Part of the map line that is parsed, the rest is skipped. */
+static const uint LINE_SIZE = 128;
+
+/*! @brief Longest printed symbol name. */
+static const uint NAME_SIZE = 64;
+
+/*! @brief Number of threads listed separately. */
+static const uint THREADS = 16;
+
+/*!
+ * @brief Parses symbol line of the linker map: "    0x80001234    name".
+ * @param line The line.
+ * @param address Address of the symbol is stored here.
+ * @param name Position of the name in the line is stored here.
+ * @return @a True if the line defines a symbol, @a false otherwise.
+ */
+static bool parse_symbol( const char* line, unative_t& address, uint& name )
+{
+	uint i = 0;
+	while (line[i] == ' ')
+		++i;
+	if (i == 0 || line[i] != '0' || line[i + 1] != 'x')
+		return false;
+
+	address = 0;
+	uint digits = 0;
+	for (i += 2; ; ++i, ++digits) {
+		const char c = line[i];
+		if (c >= '0' && c <= '9')
+			address = (address << 4) | (c - '0');
+		else if (c >= 'a' && c <= 'f')
+			address = (address << 4) | (c - 'a' + 10);
+		else
+			break;
+	}
+	if (!digits || line[i] != ' ')
+		return false;
+	while (line[i] == ' ')
+		++i;
+
+	/* section sizes, assignments and directives are not symbols */
+	if (line[i] == '\0' || line[i] == '.' || (line[i] == '0' && line[i + 1] == 'x'))
+		return false;
+	for (uint j = i; line[j]; ++j)
+		if (line[j] == '=')
+			return false;
+
+	name = i;
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+int Profiler::start( uint usec )
+{
+	if (usec < PROFILE_MIN_INTERVAL)
+		return EINVAL;
+
+	InterruptDisabler interrupts;
+
+	m_count    = 0;
+	m_usecs    = usec;
+	m_interval = usec * KERNEL.cyclesPerUsec();
+
+	/* planned events stay in the timer heap, the next interrupt replans */
+	KERNEL.setTimeInterrupt( Time() );
+	PRINT_DEBUG ("Started sampling every %u cycles.\n", m_interval);
+	return EOK;
+}
+/*----------------------------------------------------------------------------*/
+void Profiler::stop()
+{
+	/* the next timer interrupt plans the compare as usual */
+	m_interval = 0;
+}
+/*----------------------------------------------------------------------------*/
+void Profiler::sample( const Processor::Context* registers )
+{
+	if (!m_interval)
+		return;
+
+	PROFILE_SAMPLE& sample = m_samples[m_count++ % SAMPLES];
+	sample.epc    = registers->epc;
+	sample.thread = Thread::getCurrent() ? Thread::getCurrent()->id() : 0;
+	sample.asid   = Processor::reg_read_entryhi() & Processor::ASID_MASK;
+}
+/*----------------------------------------------------------------------------*/
+int Profiler::dump( const char* user_map )
+{
+	Hit* hits = NULL;
+	uint taken = 0;
+	thread_t threads[THREADS];
+	unative_t asids[THREADS];
+	uint thread_counts[THREADS];
+	uint thread_count = 0;
+	{
+		InterruptDisabler interrupts;
+		stop();
+
+		taken = min( m_count, SAMPLES );
+		hits = new Hit[taken ? taken : 1];
+		if (!hits)
+			return ENOMEM;
+
+		for (uint i = 0; i < taken; ++i) {
+			const PROFILE_SAMPLE& sample = m_samples[i];
+			hits[i].address = sample.epc;
+			hits[i].symbol  = 0;
+			hits[i].offset  = NO_SYMBOL;
+			hits[i].count   = 1;
+
+			uint t = 0;
+			while (t < thread_count && threads[t] != sample.thread)
+				++t;
+			if (t == thread_count && thread_count < THREADS) {
+				threads[t] = sample.thread;
+				asids[t] = sample.asid;
+				thread_counts[t] = 0;
+				++thread_count;
+			}
+			if (t < thread_count)
+				++thread_counts[t];
+		}
+	}
+
+	printf( "Profile: %u samples every %u usecs, %u overwritten.\n",
+		taken, m_usecs, m_count - taken );
+	uint listed = 0;
+	for (uint t = 0; t < thread_count; ++t) {
+		printf( " thread %u (ASID %u): %u samples\n",
+			threads[t], asids[t], thread_counts[t] );
+		listed += thread_counts[t];
+	}
+	if (listed < taken)
+		printf( " other threads: %u samples\n", taken - listed );
+
+	if (!taken) {
+		delete[] hits;
+		return EOK;
+	}
+
+	/* merge samples of the same address */
+	sort( hits, taken, false );
+	uint distinct = 1;
+	for (uint i = 1; i < taken; ++i) {
+		if (hits[i].address == hits[distinct - 1].address)
+			++hits[distinct - 1].count;
+		else
+			hits[distinct++] = hits[i];
+	}
+
+	/* user addresses are below the kernel ones */
+	uint user = 0;
+	while (user < distinct && hits[user].address < ADDR_PREFIX_KSEG0)
+		++user;
+
+	if (user && user_map && !resolve( hits, user, user_map ))
+		printf( "Map %s not found, user addresses are not resolved.\n", user_map );
+	if (user < distinct && !resolve( hits + user, distinct - user, KERNEL_MAP ))
+		printf( "Map %s not found, kernel addresses are not resolved.\n", KERNEL_MAP );
+
+	/* merge addresses of the same symbol */
+	uint symbols = 1;
+	for (uint i = 1; i < distinct; ++i) {
+		Hit& last = hits[symbols - 1];
+		if (hits[i].offset != NO_SYMBOL && last.offset != NO_SYMBOL
+		    && hits[i].symbol == last.symbol)
+			last.count += hits[i].count;
+		else
+			hits[symbols++] = hits[i];
+	}
+
+	sort( hits, symbols, true );
+	printf( "SAMPLES\tPERCENT\tSPACE\tSYMBOL\n" );
+	for (uint i = 0; i < min( symbols, TOP ); ++i) {
+		const Hit& hit = hits[i];
+		const bool kernel = hit.address >= ADDR_PREFIX_KSEG0;
+		const uint permille = hit.count * 1000 / taken;
+		printf( "%u\t%u.%u\t%s\t", hit.count, permille / 10, permille % 10,
+			kernel ? "kernel" : "user" );
+		if (hit.offset == NO_SYMBOL)
+			printf( "%p", hit.address );
+		else
+			printName( kernel ? KERNEL_MAP : user_map, hit.offset );
+		printf( "\n" );
+	}
+
+	delete[] hits;
+	return EOK;
+}
+/*----------------------------------------------------------------------------*/
+bool Profiler::resolve( Hit* hits, uint count, const char* map )
+{
+	ASSERT (KERNEL.rootFS());
+	Entry* entry = KERNEL.rootFS()->getFile( map );
+	if (!entry || !entry->fileEntry() || !entry->open( OPEN_R ))
+		return false;
+	FileEntry* file = entry->fileEntry();
+
+	const size_t BUFFER_SIZE = 512;
+	char buffer[BUFFER_SIZE];
+	char line[LINE_SIZE];
+	uint length = 0;
+	uint line_start = 0;
+
+	/* readAt fails for reads past the end, the last chunk is clamped */
+	uint pos = 0;
+	ssize_t res = 0;
+	while (pos < file->size() && (res = file->readAt(
+	    buffer, min<size_t>( BUFFER_SIZE, file->size() - pos ), pos )) > 0) {
+		for (ssize_t i = 0; i < res; ++i) {
+			if (buffer[i] != '\n') {
+				if (length < LINE_SIZE - 1)
+					line[length++] = buffer[i];
+				continue;
+			}
+			line[length] = '\0';
+			unative_t address;
+			uint name;
+			if (parse_symbol( line, address, name ))
+				assign( hits, count, address, line_start + name );
+			length = 0;
+			line_start = pos + i + 1;
+		}
+		pos += res;
+	}
+	/* the last line might miss its newline */
+	if (length) {
+		line[length] = '\0';
+		unative_t address;
+		uint name;
+		if (parse_symbol( line, address, name ))
+			assign( hits, count, address, line_start + name );
+	}
+
+	entry->close();
+	PRINT_DEBUG ("Resolved %u addresses against %s (%u bytes).\n", count, map, pos);
+	return true;
+}
+/*----------------------------------------------------------------------------*/
+void Profiler::assign( Hit* hits, uint count, unative_t symbol, uint offset )
+{
+	/* the first hit at or above the symbol */
+	uint low = 0, high = count;
+	while (low < high) {
+		const uint middle = (low + high) / 2;
+		if (hits[middle].address < symbol)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	/* hits above one with a closer symbol have a closer symbol as well */
+	for (uint i = low; i < count; ++i) {
+		if (hits[i].offset != NO_SYMBOL && hits[i].symbol >= symbol)
+			break;
+		hits[i].symbol = symbol;
+		hits[i].offset = offset;
+	}
+}
+/*----------------------------------------------------------------------------*/
+void Profiler::printName( const char* map, uint offset )
+{
+	Entry* entry = KERNEL.rootFS()->getFile( map );
+	if (!entry || !entry->fileEntry() || !entry->open( OPEN_R ))
+		return;
+
+	FileEntry* file = entry->fileEntry();
+	char name[NAME_SIZE];
+	/* name of the last symbol ends with the file */
+	const ssize_t res = (offset < file->size())
+		? file->readAt( name, min<size_t>( NAME_SIZE - 1, file->size() - offset ), offset )
+		: 0;
+	entry->close();
+
+	uint length = 0;
+	while (length < (uint)max( res, (ssize_t)0 )
+	    && name[length] != '\n' && name[length] != '\r')
+		++length;
+	name[length] = '\0';
+	printf( "%s", name );
+}
+/*----------------------------------------------------------------------------*/
+void Profiler::sort( Hit* hits, uint count, bool by_count )
+{
+	static const uint GAPS[] = { 701, 301, 132, 57, 23, 10, 4, 1 };
+
+	for (uint g = 0; g < sizeof(GAPS) / sizeof(GAPS[0]); ++g) {
+		const uint gap = GAPS[g];
+		for (uint i = gap; i < count; ++i) {
+			const Hit hit = hits[i];
+			uint j = i;
+			while (j >= gap && (by_count
+			    ? hits[j - gap].count < hit.count
+			    : hits[j - gap].address > hit.address)) {
+				hits[j] = hits[j - gap];
+				j -= gap;
+			}
+			hits[j] = hit;
+		}
+	}
+}
@@ -0,0 +1,155 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*!
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Profiler class declaration.
+ *
+ * Statistical profiler sampling the interrupted instruction on timer
+ * interrupts.
+ */
+#pragma once
+
+#include "api.h"
+#include "profile.h"
+#include "Singleton.h"
+#include "drivers/Processor.h"
+
+/*!
+ * @class Profiler Profiler.h "timer/Profiler.h"
+ * @brief Samples the running code on timer interrupts.
+ *
+ * While the profiler runs the compare interrupt is planned at least every
+ * sampling interval (see Kernel::setTimeInterrupt()), each timer interrupt
+ * stores the interrupted EPC, the running thread and the ASID to the
+ * sample ring. There is one CPU and so one ring, the oldest samples are
+ * overwritten when it is full.
+ *
+ * The histogram is resolved against linker map files on the root
+ * filesystem: kernel addresses against kernel.map, user addresses against
+ * the map of the profiled program.
+ */
+class Profiler: public Singleton<Profiler>
+{
+public:
+	/*! @brief Size of the sample ring. */
+	static const uint SAMPLES = 4096;
+
+	/*! @brief Number of symbols in the histogram. */
+	static const uint TOP = 20;
+
+	/*!
+	 * @brief Clears the samples and starts sampling.
+	 * @param usec Sampling interval in microseconds.
+	 * @return EOK on success, EINVAL if the interval is shorter
+	 * 	than PROFILE_MIN_INTERVAL.
+	 */
+	int start( uint usec );
+
+	/*! @brief Stops sampling, taken samples are kept. */
+	void stop();
+
+	/*!
+	 * @brief Gets the sampling interval.
+	 * @return Interval in CP0 Count cycles, 0 if the profiler is stopped.
+	 */
+	inline unative_t interval() const { return m_interval; };
+
+	/*!
+	 * @brief Takes a sample if the profiler is running.
+	 * @param registers Context of the interrupted code.
+	 */
+	void sample( const Processor::Context* registers );
+
+	/*!
+	 * @brief Prints the histogram of the samples to the console.
+	 * @param user_map Map file of the profiled program,
+	 * 	NULL to leave user addresses unresolved.
+	 * @return EOK on success, ENOMEM if there is no memory for the
+	 * 	histogram.
+	 *
+	 * Stops the profiler. Functions are sorted by the number of samples,
+	 * TOP of them are printed.
+	 */
+	int dump( const char* user_map );
+
+private:
+	/*! @brief Sampled address and the symbol it belongs to. */
+	struct Hit {
+		unative_t address;  /*!< Sampled address (symbol after grouping). */
+		unative_t symbol;   /*!< Closest symbol at or below the address.  */
+		uint offset;        /*!< Position of the symbol name in the map.  */
+		uint count;         /*!< Number of samples.                       */
+	};
+
+	/*! @brief Offset of unresolved hits. */
+	static const uint NO_SYMBOL = (uint)-1;
+
+	PROFILE_SAMPLE m_samples[SAMPLES]; /*!< Sample ring.                    */
+	uint m_count;                      /*!< Samples taken since the start.  */
+	uint m_usecs;                      /*!< Interval in microseconds.       */
+	unative_t m_interval;              /*!< Interval in cycles, 0 if off.   */
+
+	/*! @brief Creates stopped profiler. */
+	Profiler(): m_count( 0 ), m_usecs( 0 ), m_interval( 0 ) {};
+
+	/*!
+	 * @brief Finds symbols of sorted distinct addresses.
+	 * @param hits Addresses to resolve, sorted.
+	 * @param count Number of hits.
+	 * @param map Name of the map file.
+	 * @return @a True if the map was read, @a false otherwise.
+	 */
+	static bool resolve( Hit* hits, uint count, const char* map );
+
+	/*!
+	 * @brief Assigns symbol to the hits it is the closest symbol of.
+	 * @param hits Sorted hits.
+	 * @param count Number of hits.
+	 * @param symbol Address of the symbol.
+	 * @param offset Position of the symbol name in the map.
+	 */
+	static void assign( Hit* hits, uint count, unative_t symbol, uint offset );
+
+	/*!
+	 * @brief Prints the symbol name stored in the map.
+	 * @param map Name of the map file.
+	 * @param offset Position of the name.
+	 */
+	static void printName( const char* map, uint offset );
+
+	/*!
+	 * @brief Shell sort of the hits.
+	 * @param hits Hits to sort.
+	 * @param count Number of hits.
+	 * @param by_count Sort by count descending if @a true, by address
+	 * 	ascending otherwise.
+	 */
+	static void sort( Hit* hits, uint count, bool by_count );
+
+	friend class Singleton<Profiler>;
+};
+
+#define PROFILER Profiler::instance()
@@ -35,6 +35,7 @@
 #include "Timer.h"
 #include "Kernel.h"
 #include "InterruptDisabler.h"
+#include "Tracer.h"
 
 //#define TIMER_DEBUG
 
@@ -110,6 +111,7 @@ void Timer::handleInterrupt()
 			/* Other thread might have only requested waking up */
 			ASSERT (thr->status() != Thread::READY);
 			PRINT_DEBUG ("Waking thread %u.\n", thr->id());
+			TRACE( TIMER_WAKE, thr->id(), 0 );
 			thr->resume();
 		}
 	}
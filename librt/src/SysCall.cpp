@@ -36,21 +36,32 @@
 #include "syscallcodes.h"
 using namespace SysCall;
 #define QUOT(expr) #expr
+/* syscall code goes in v0 (read by the kernel) and in the instruction */
 #define SYSCALL( call ) \
 ({ \
-  register native_t __v0 asm("$2");\
+  register native_t __v0 asm("$2") = call;\
   \
   asm volatile ( \
     "syscall "QUOT(call)" \n"\
-    :"=r"(__v0)\
+    :"+r"(__v0)\
     ::\
   );\
   __v0;\
 })
 
-size_t SysCall::puts( const char* str )
+int SysCall::write( file_t fd, const void* buffer, size_t size )
 {
-	return SYSCALL( SYS_PUTS );
+	return SYSCALL( SYS_WRITE );
+}
+/*----------------------------------------------------------------------------*/
+int SysCall::nop()
+{
+	return SYSCALL( SYS_NOP );
+}
+/*----------------------------------------------------------------------------*/
+int SysCall::submit()
+{
+	return SYSCALL( SYS_SUBMIT );
 }
 /*----------------------------------------------------------------------------*/
 size_t SysCall::gets( char* buffer, size_t size)
@@ -168,6 +179,11 @@ int SysCall::process_create( process_t *process_ptr, const void *img, const size
 	return SYSCALL( SYS_PROC_CREATE );
 }
 /*----------------------------------------------------------------------------*/
+int SysCall::process_spawn( process_t *process_ptr, const char* file_name )
+{
+	return SYSCALL( SYS_PROC_SPAWN );
+}
+/*----------------------------------------------------------------------------*/
 int SysCall::process_join( process_t proc, const Time * time )
 {
 	return SYSCALL( SYS_PROC_JOIN );
@@ -178,6 +194,26 @@ int SysCall::process_kill( process_t proc )
 	return SYSCALL( SYS_PROC_KILL );
 }
 /*----------------------------------------------------------------------------*/
+int SysCall::process_stat( process_t proc, PROCESS_STAT* stat )
+{
+	return SYSCALL( SYS_STAT_PROCESS );
+}
+/*----------------------------------------------------------------------------*/
+int SysCall::thread_stat( thread_t thr, THREAD_STAT* stat )
+{
+	return SYSCALL( SYS_STAT_THREAD );
+}
+/*----------------------------------------------------------------------------*/
+int SysCall::profile( uint command, unative_t arg )
+{
+	return SYSCALL( SYS_PROFILE );
+}
+/*----------------------------------------------------------------------------*/
+int SysCall::trace( uint command, unative_t arg0, unative_t arg1 )
+{
+	return SYSCALL( SYS_TRACE );
+}
+/*----------------------------------------------------------------------------*/
 int SysCall::open( file_t* fd, const char* file_name, const char mode )
 {
 	return SYSCALL( SYS_FS_OPEN );
@@ -193,11 +229,41 @@ int SysCall::fread( file_t fd, void* buffer, size_t size )
 	return SYSCALL( SYS_FS_READ );
 }
 /*----------------------------------------------------------------------------*/
+int SysCall::fwrite( file_t fd, const void* buffer, size_t size )
+{
+	return SYSCALL( SYS_FS_WRITE );
+}
+/*----------------------------------------------------------------------------*/
+int SysCall::fsync( file_t fd )
+{
+	return SYSCALL( SYS_FS_SYNC );
+}
+/*----------------------------------------------------------------------------*/
 int SysCall::fseek( file_t fd, int, int offset )
 {
 	return SYSCALL( SYS_FS_SEEK );
 }
 /*----------------------------------------------------------------------------*/
+int SysCall::fmmap( file_t fd, void** from, size_t offset, size_t* size )
+{
+	return SYSCALL( SYS_FS_MMAP );
+}
+/*----------------------------------------------------------------------------*/
+int SysCall::fread_async( AIO_READ* request )
+{
+	return SYSCALL( SYS_FS_READ_ASYNC );
+}
+/*----------------------------------------------------------------------------*/
+int SysCall::pread( file_t fd, void* buffer, size_t size, size_t offset )
+{
+	return SYSCALL( SYS_FS_PREAD );
+}
+/*----------------------------------------------------------------------------*/
+int SysCall::readv( file_t fd, const IOVEC* iov, uint count )
+{
+	return SYSCALL( SYS_FS_READV );
+}
+/*----------------------------------------------------------------------------*/
 int SysCall::direntry( file_t dir_d, DIR_ENTRY* entry )
 {
 	return SYSCALL( SYS_FS_ENTRY );
@@ -37,6 +37,9 @@
 #include "api.h"
 #include "Time.h"
 #include "direntry.h"
+#include "aio.h"
+#include "iovec.h"
+#include "stat.h"
 
 /*!
  * @namespace SysCall
@@ -47,10 +50,14 @@
 namespace SysCall
 {
 
-size_t puts( const char* str );
+int write( file_t fd, const void* buffer, size_t size );
 
 size_t gets( char* buffer, size_t size);
 
+int nop();
+
+int submit();
+
 /*----------------------------------------------------------------------------*/
 int thread_create(
 	thread_t *thread_ptr, void *(*thread_start)(void*, void*), void *arg, void* arg2 );
@@ -128,6 +135,16 @@ int process_join( process_t proc, const Time * time );
 
 int process_kill( process_t proc );
 
+int process_spawn( process_t *process_ptr, const char* file_name );
+
+int process_stat( process_t proc, PROCESS_STAT* stat );
+
+int thread_stat( thread_t thr, THREAD_STAT* stat );
+
+int profile( uint command, unative_t arg );
+
+int trace( uint command, unative_t arg0, unative_t arg1 );
+
 
 void exit() __attribute__ ((noreturn));
 /*----------------------------------------------------------------------------*/
@@ -137,7 +154,19 @@ int close( file_t fd );
 
 int fread( file_t fd, void* buffer, size_t size );
 
+int fwrite( file_t fd, const void* buffer, size_t size );
+
+int fsync( file_t fd );
+
 int fseek( file_t fd, int pos, int offset );
 
 int direntry( file_t fd, DIR_ENTRY* entry );
+
+int fmmap( file_t fd, void** from, size_t offset, size_t* size );
+
+int fread_async( AIO_READ* request );
+
+int pread( file_t fd, void* buffer, size_t size, size_t offset );
+
+int readv( file_t fd, const IOVEC* iov, uint count );
 }
@@ -35,7 +35,9 @@
 #include "api.h"
 #include "Time.h"
 #include "SysCall.h"
+#include "ProcessInfo.h"
 
+extern ProcessInfo * INFO;
 
 Time Time::getCurrentTime()
 {
@@ -43,3 +45,16 @@ Time Time::getCurrentTime()
 	SysCall::getCurrentTime(&result);
 	return result;
 }
+
+Time Time::getCoarseTime()
+{
+	/* kernel exports the time of the last tick or switch in,
+	 * odd sequence means the update is in progress */
+	uint sequence, secs, usecs;
+	do {
+		sequence = INFO->ClockSequence;
+		secs  = INFO->ClockSecs;
+		usecs = INFO->ClockUsecs;
+	} while (sequence != INFO->ClockSequence || (sequence & 1));
+	return Time( secs, usecs );
+}
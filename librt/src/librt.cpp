@@ -40,6 +40,8 @@
 #include "assert.h"
 #include "UserMemoryAllocator.h"
 #include "ProcessInfo.h"
+#include "putc_a.h"
+#include "atomic.h"
 
 ProcessInfo * INFO;
 
@@ -62,18 +64,38 @@ void* thread_start( void* func, void* data)
 /* Basic IO */
 size_t putc( const char c )
 {
-	static char buffer[2] = { '\0', '\0' };
-	buffer[0] = c;
-	return SysCall::puts( buffer );
+	return putc_a( c );
 }
 /*----------------------------------------------------------------------------*/
 size_t puts( const char* str )
 {
-	return SysCall::puts( str );
+	size_t count = 0;
+	for (;*str; ++str)
+		count += putc_a( *str );
+	return count;
+}
+/*----------------------------------------------------------------------------*/
+int fflush( file_t fd )
+{
+	if (fd != STDOUT && fd != STDERR)
+		return EOK;
+	output_flush();
+	return EOK;
+}
+/*----------------------------------------------------------------------------*/
+int stdout_buffering( int mode )
+{
+	return output_buffering( mode );
+}
+/*----------------------------------------------------------------------------*/
+int syscall_nop()
+{
+	return SysCall::nop();
 }
 /*----------------------------------------------------------------------------*/
 char getc()
 {
+	output_flush();
 	char buffer;
 	SysCall::gets( &buffer, 1);
 	return buffer;
@@ -81,6 +103,7 @@ char getc()
 /*----------------------------------------------------------------------------*/
 ssize_t gets( char* str, const size_t len )
 {
+	output_flush();
 	/* we don't need to call syscall just to report error */
 	if (!len) return EINVAL;
 	return SysCall::gets( str, len );
@@ -201,6 +224,7 @@ int thread_wakeup( thread_t thr )
 /* -------------------------------------------------------------------------- */
 void thread_exit( void* thread_retval )
 {
+	output_release();
 	SysCall::thread_exit( thread_retval );
 }
 /* -------------------------------------------------------------------------- */
@@ -212,6 +236,11 @@ int process_create(
 	return SysCall::process_create( process_ptr, img, size );
 }
 /*----------------------------------------------------------------------------*/
+int process_spawn( process_t *process_ptr, const char* file_name )
+{
+	return SysCall::process_spawn( process_ptr, file_name );
+}
+/*----------------------------------------------------------------------------*/
 process_t process_self()
 {
 	return INFO->PID;
@@ -235,6 +264,7 @@ int process_kill( process_t proc )
 /*----------------------------------------------------------------------------*/
 void exit()
 {
+	output_flush_all();
 	SysCall::exit();
 }
 /* -------------------------------------------------------------------------- */
@@ -348,11 +378,60 @@ int fread( file_t fd, void* buffer, size_t size )
 	return SysCall::fread( fd, buffer, size);
 }
 /*----------------------------------------------------------------------------*/
+int fwrite( file_t fd, const void* buffer, size_t size )
+{
+	return SysCall::fwrite( fd, buffer, size );
+}
+/*----------------------------------------------------------------------------*/
+int fsync( file_t fd )
+{
+	return SysCall::fsync( fd );
+}
+/*----------------------------------------------------------------------------*/
 int fseek( file_t fd, int pos, int offset)
 {
 	return SysCall::fseek( fd, pos, offset );
 }
 /*----------------------------------------------------------------------------*/
+int pread( file_t fd, void* buffer, size_t size, size_t offset )
+{
+	return SysCall::pread( fd, buffer, size, offset );
+}
+/*----------------------------------------------------------------------------*/
+int readv( file_t fd, const IOVEC* iov, uint count )
+{
+	return SysCall::readv( fd, iov, count );
+}
+/*----------------------------------------------------------------------------*/
+int fmmap( file_t fd, void** from, size_t offset, size_t* size )
+{
+	return SysCall::fmmap( fd, from, offset, size );
+}
+/*----------------------------------------------------------------------------*/
+int aio_init( AIO_READ* request )
+{
+	request->pending = 0;
+	request->result  = 0;
+	return SysCall::event_init( &request->event );
+}
+/*----------------------------------------------------------------------------*/
+int fread_async( AIO_READ* request )
+{
+	return SysCall::fread_async( request );
+}
+/*----------------------------------------------------------------------------*/
+int aio_wait( AIO_READ* request )
+{
+	while (request->pending)
+		SysCall::event_wait( request->event, &request->pending );
+	return request->result;
+}
+/*----------------------------------------------------------------------------*/
+int aio_destroy( AIO_READ* request )
+{
+	return SysCall::event_destroy( request->event );
+}
+/*----------------------------------------------------------------------------*/
 int opendir( file_t* fd_ptr, const char* path )
 {
 	return SysCall::open( fd_ptr, path );
@@ -367,3 +446,105 @@ int direntry( file_t dir_fd, DIR_ENTRY* entry )
 {
 	return SysCall::direntry( dir_fd, entry );
 }
+/* -------------------------------------------------------------------------- */
+/* -------------------------   BATCHED SYSCALLS   --------------------------- */
+/* -------------------------------------------------------------------------- */
+/*! @brief Guards librt side of the ring against other threads. */
+static volatile native_t ring_lock = 0;
+
+static void lock_ring()
+{
+	while (swap( ring_lock, 1 ))
+		thread_yield();
+}
+/*----------------------------------------------------------------------------*/
+static void unlock_ring()
+{
+	swap( ring_lock, 0 );
+}
+/*----------------------------------------------------------------------------*/
+int submit_add( unsigned int code, unative_t p0, unative_t p1,
+	unative_t p2, unative_t p3, unative_t tag )
+{
+	if (code == SYS_SUBMIT || code == SYS_EXIT || code == SYS_THREAD_EXIT)
+		return EINVAL;
+
+	SUBMIT_RING& ring = INFO->Ring;
+	lock_ring();
+	const uint tail = ring.sq_tail;
+	if (tail - ring.sq_head == SUBMIT_RING_SIZE) {
+		unlock_ring();
+		return EWOULDBLOCK;
+	}
+
+	SUBMIT_ENTRY& entry = ring.sq[tail % SUBMIT_RING_SIZE];
+	entry.code = code;
+	entry.params[0] = p0;
+	entry.params[1] = p1;
+	entry.params[2] = p2;
+	entry.params[3] = p3;
+	entry.tag = tag;
+	/* all fields are volatile, the entry is complete before it is visible */
+	ring.sq_tail = tail + 1;
+	unlock_ring();
+	return EOK;
+}
+/*----------------------------------------------------------------------------*/
+int submit()
+{
+	return SysCall::submit();
+}
+/*----------------------------------------------------------------------------*/
+int submit_reap( unative_t* tag, unative_t* result )
+{
+	SUBMIT_RING& ring = INFO->Ring;
+	lock_ring();
+	const uint head = ring.cq_head;
+	COMPLETION_ENTRY& completion = ring.cq[head % SUBMIT_RING_SIZE];
+	if (head == ring.cq_tail || !completion.ready) {
+		unlock_ring();
+		return EWOULDBLOCK;
+	}
+
+	if (tag) *tag = completion.tag;
+	if (result) *result = completion.result;
+	ring.cq_head = head + 1;
+	unlock_ring();
+	return EOK;
+}
+/*----------------------------------------------------------------------------*/
+int process_stat( process_t proc, PROCESS_STAT* stat )
+{
+	return SysCall::process_stat( proc, stat );
+}
+/*----------------------------------------------------------------------------*/
+int thread_stat( thread_t thr, THREAD_STAT* stat )
+{
+	return SysCall::thread_stat( thr, stat );
+}
+/*----------------------------------------------------------------------------*/
+int profile_start( const unsigned int usec )
+{
+	return SysCall::profile( PROFILE_START, usec );
+}
+/*----------------------------------------------------------------------------*/
+void profile_stop()
+{
+	SysCall::profile( PROFILE_STOP, 0 );
+}
+/*----------------------------------------------------------------------------*/
+int profile_dump( const char* map )
+{
+	output_flush();
+	return SysCall::profile( PROFILE_DUMP, (unative_t)map );
+}
+/*----------------------------------------------------------------------------*/
+unsigned int trace_enable( const unsigned int mask )
+{
+	return SysCall::trace( TRACE_COMMAND_ENABLE, mask, 0 );
+}
+/*----------------------------------------------------------------------------*/
+int trace_read( TRACE_RECORD* buffer, const unsigned int count )
+{
+	return SysCall::trace( TRACE_COMMAND_READ, (unative_t)buffer, count );
+}
@@ -25,34 +25,133 @@
 
 /*!
  * @file 
- * @brief putc_a function using buffer to write to the console to save
- * time with syscalls.
+ * @brief putc_a function using per-thread buffers to write to the console
+ * to save time with syscalls.
+ *
+ * Every thread gets its own buffer, so lines of different threads are not
+ * mixed. Buffers are written by one SYS_WRITE (with length, to STDOUT)
+ * at the end of the line, when full, or on fflush(), depending on the
+ * mode set by stdout_buffering().
  */
 
 #include "types.h"
+#include "atomic.h"
+#include "librt.h"
+#include "SysCall.h"
+#include "putc_a.h"
 
-extern "C" size_t puts( const char * str );
+/*! @brief Size of one thread buffer. */
+#define OUTPUT_BUFFER_SIZE 128
 
+/*! @brief Number of buffers, threads without one write directly. */
+#define OUTPUT_BUFFERS 16
+
+/*! @brief Output buffer of one thread. */
+struct OutputBuffer {
+	volatile native_t used;        /*!< Buffer is owned by a thread.  */
+	volatile thread_t owner;       /*!< Owning thread.                */
+	size_t count;                  /*!< Number of buffered chars.     */
+	char data[OUTPUT_BUFFER_SIZE]; /*!< Buffered chars.               */
+};
+
+static OutputBuffer buffers[OUTPUT_BUFFERS];
+
+static int buffering = OUTPUT_LINE;
+
+/*----------------------------------------------------------------------------*/
+static void write_out( const char* data, size_t count )
+{
+	while (count) {
+		const int written = SysCall::write( STDOUT, data, count );
+		if (written <= 0) return;
+		data  += written;
+		count -= written;
+	}
+}
+/*----------------------------------------------------------------------------*/
+static OutputBuffer* thread_buffer( bool create )
+{
+	const thread_t self = thread_self();
+	const uint start = self % OUTPUT_BUFFERS;
+
+	for (uint i = 0; i < OUTPUT_BUFFERS; ++i) {
+		OutputBuffer& buffer = buffers[(start + i) % OUTPUT_BUFFERS];
+		if (buffer.used && buffer.owner == self)
+			return &buffer;
+	}
+	if (!create) return NULL;
+
+	for (uint i = 0; i < OUTPUT_BUFFERS; ++i) {
+		OutputBuffer& buffer = buffers[(start + i) % OUTPUT_BUFFERS];
+		if (!buffer.used && !swap( buffer.used, 1 )) {
+			buffer.count = 0;
+			buffer.owner = self;
+			return &buffer;
+		}
+	}
+	return NULL;
+}
+/*----------------------------------------------------------------------------*/
+static void flush_buffer( OutputBuffer& buffer )
+{
+	write_out( buffer.data, buffer.count );
+	buffer.count = 0;
+}
+/*----------------------------------------------------------------------------*/
 size_t putc_a( const char c )
 {
-  const size_t BUFFER_SIZE = 80;
-  
-  static char buffer[BUFFER_SIZE];
-  static off_t pos = 0;
-  
-  if (c == '\0') {
-    buffer[pos] = c;
-    puts(buffer);
-    pos = 0;
-    
-    return 0;
-  } else {
-    buffer[pos++] = c;
-    if (pos == BUFFER_SIZE || c == '\n') { 
-		putc_a('\0'); 
+	/* zero only flushes, as it always did */
+	if (c == '\0') {
+		output_flush();
+		return 0;
+	}
+
+	OutputBuffer* buffer =
+		(buffering == OUTPUT_UNBUFFERED) ? NULL : thread_buffer( true );
+	if (!buffer) {
+		write_out( &c, 1 );
+		return 1;
 	}
-    
-    return 1;
-  }
 
+	buffer->data[buffer->count++] = c;
+	if (buffer->count == OUTPUT_BUFFER_SIZE
+		|| (c == '\n' && buffering == OUTPUT_LINE)) {
+		flush_buffer( *buffer );
+	}
+	return 1;
+}
+/*----------------------------------------------------------------------------*/
+void output_flush()
+{
+	OutputBuffer* buffer = thread_buffer( false );
+	if (buffer)
+		flush_buffer( *buffer );
+}
+/*----------------------------------------------------------------------------*/
+void output_release()
+{
+	OutputBuffer* buffer = thread_buffer( false );
+	if (!buffer) return;
+	flush_buffer( *buffer );
+	buffer->used = 0;
+}
+/*----------------------------------------------------------------------------*/
+void output_flush_all()
+{
+	/* other threads are not running anymore, process is exiting */
+	for (uint i = 0; i < OUTPUT_BUFFERS; ++i) {
+		if (buffers[i].used)
+			flush_buffer( buffers[i] );
+	}
+}
+/*----------------------------------------------------------------------------*/
+int output_buffering( int mode )
+{
+	if (mode != OUTPUT_UNBUFFERED && mode != OUTPUT_LINE && mode != OUTPUT_FULL)
+		return EINVAL;
+	const int previous = buffering;
+	/* data buffered in the old mode would wait for the next flush */
+	output_flush();
+	buffering = mode;
+	return previous;
 }
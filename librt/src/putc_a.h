@@ -28,4 +28,25 @@
  * @brief putc_a function.
  */
 
+/*!
+ * @brief Writes char to the output buffer of the current thread.
+ * @param c The char, zero only flushes the buffer.
+ * @return Number of written chars.
+ */
 size_t putc_a( const char c );
+
+/*! @brief Writes the output buffer of the current thread. */
+void output_flush();
+
+/*! @brief Writes and frees the output buffer of the exiting thread. */
+void output_release();
+
+/*! @brief Writes buffers of all threads, used when the process exits. */
+void output_flush_all();
+
+/*!
+ * @brief Sets buffering mode of the standard output.
+ * @param mode One of OutputBuffering modes.
+ * @return Previous mode, EINVAL if @a mode is not valid.
+ */
+int output_buffering( int mode );
@@ -31,15 +31,25 @@
 #pragma once
 
 #include "types.h"
+#include "submit.h"
 
 /*!
  * @struct ProcessInfo ProcessInfo.h "ProcessInfo.h"
  * @brief Class used for exporting some data into userspace.
+ *
+ * Clock fields hold the time of the last timer interrupt or switch to
+ * one of its threads, so librt reads the coarse time without a syscall.
+ * @a ClockSequence is odd while the clock is updated and changes with
+ * every update, a reader that sees it odd or changed retries.
  */
 struct ProcessInfo
 {
 	process_t PID;            /*!< ID of the current process. */
 	thread_t  RunningThread;  /*!< ID of the current thread.  */
+	SUBMIT_RING Ring;         /*!< Batched syscalls.          */
+	volatile uint ClockSequence; /*!< Number of clock updates.   */
+	volatile uint ClockSecs;     /*!< Seconds of the last update. */
+	volatile uint ClockUsecs;    /*!< Microseconds of the update. */
 };
 
 
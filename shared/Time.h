@@ -249,6 +249,16 @@ public:
 	 */
 	static Time getCurrentTime();
 
+	/** @brief Gets time of the last clock tick.
+	 *
+	 * Userspace reads the time exported by the kernel into ProcessInfo
+	 * without a syscall, it is updated on timer interrupts and when
+	 * a thread of the process is switched in, so it is at most one
+	 * scheduling quantum old. Kernel returns the current time.
+	 * Use getCurrentTime() to time short intervals.
+	 */
+	static Time getCoarseTime();
+
 	/** @brief Gets current time.
 	*
 	* Returned time should not differ from actual time by more than 1 second.
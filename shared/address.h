@@ -58,6 +58,13 @@ inline T ADDR_TO_KSEG0(T addr)
 /* first bit is not one */
 #define ADDR_IN_USEG(addr)	(! (addr & ADDR_PREFIX_KSEG0) )
 
+/* USEG ends where KSEG0 starts */
+#define ADDR_USEG_END ADDR_PREFIX_KSEG0
+
+/* size bytes from addr fit in USEG, addr + size must not wrap */
+#define ADDR_RANGE_IN_USEG(addr, size) \
+	( ADDR_IN_USEG(addr) && (size) <= ADDR_USEG_END - (addr) )
+
 #define ADDR_SIZE_KSEG0 (ADDR_PREFIX_KSEG1 - ADDR_PREFIX_KSEG0)	/*! 0.5 GB */
 
 /* Entry points (jumps to C++ code) */
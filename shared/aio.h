@@ -0,0 +1,51 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Asynchronous read request shared by the kernel and librt.
+ */
+
+#pragma once
+
+#include "types.h"
+
+/*!
+ * @brief Asynchronous read request, see fread_async().
+ *
+ * Kernel sets @a pending when the read is accepted. When the data are in
+ * @a buffer it stores the number of bytes read (or an error code)
+ * to @a result, clears @a pending and fires @a event.
+ */
+typedef struct aio_read
+{
+	file_t fd;                /*!< Opened file to read from.           */
+	void* buffer;             /*!< Destination of the data.            */
+	size_t size;              /*!< Number of bytes to read.            */
+	size_t offset;            /*!< Position of the first byte.         */
+	event_t event;            /*!< Event fired on completion.          */
+	volatile native_t pending;/*!< Nonzero while the read is running.  */
+	volatile int result;      /*!< Bytes read or error code.           */
+} AIO_READ;
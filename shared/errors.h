@@ -39,5 +39,6 @@ enum errors {
 	ETIMEDOUT   = -4, /*!< Time limit reached.               */
 	EWOULDBLOCK = -5, /*!< Operation would block.            */
 	EOTHER      = -6,
-	EIO         = -7  /*!< Error in I/O operation.           */
+	EIO         = -7, /*!< Error in I/O operation.           */
+	ENOSPC      = -8  /*!< No space left on the device.      */
 };
@@ -61,6 +61,38 @@ char getc();
 
 ssize_t gets( char* str, const size_t len );
 
+/*! @brief Buffering modes of the standard output. */
+enum OutputBuffering {
+	OUTPUT_UNBUFFERED, /*!< Every char is written immediately.    */
+	OUTPUT_LINE,       /*!< Written at the end of line (default). */
+	OUTPUT_FULL        /*!< Written when the buffer is full.      */
+};
+
+/*!
+ * @brief Writes data buffered by the current thread.
+ *
+ * Every thread buffers its own output, lines of different threads are
+ * never mixed. Buffers of all threads are written on exit().
+ * @param fd STDOUT or STDERR, nothing is buffered for other files.
+ * @return EOK.
+ */
+int fflush( file_t fd );
+
+/*!
+ * @brief Sets buffering of the standard output for the whole process.
+ * @param mode One of OutputBuffering modes.
+ * @return Previous mode, EINVAL if @a mode is not valid.
+ */
+int stdout_buffering( int mode );
+
+/*!
+ * @brief Enters the kernel and returns, does nothing else.
+ *
+ * Measures the cost of a syscall.
+ * @return EOK.
+ */
+int syscall_nop();
+
 /* -------------------------------------------------------------------------- */
 /* ---------------------------   MEMORY   ----------------------------------- */
 /* -------------------------------------------------------------------------- */
@@ -249,6 +281,19 @@ void thread_exit( void *thread_retval ) __attribute__ ((noreturn)) ;
  */
 int process_create(
           process_t *process_ptr, const void *img, const size_t size);
+/*!
+ * @brief Creates new process from the executable file.
+ *
+ * Image is read from the disk straight into the memory of the new process,
+ * there is no need to read it into a buffer and use process_create().
+ * @param process_ptr Place where id of the new process will be stored.
+ * @param file_name Name of the executable file.
+ * @retval EOK if process was created successfully.
+ * @retval EIO if the file could not be opened.
+ * @retval ENOMEM if there was not enough free memory to create the process.
+ */
+int process_spawn( process_t *process_ptr, const char* file_name );
+
 /*!
  * @brief Gets identifier of the currently running process.
  * @return ID of the current process.
@@ -453,14 +498,245 @@ int fclose( file_t fd );
 
 int fread( file_t fd, void* buffer, size_t size );
 
+/*!
+ * @brief Appends data to the end of the file.
+ *
+ * Only the last file on the disk can be opened with OPEN_A. Data are
+ * written to the disk cache, use fsync() to make sure they are stored.
+ * STDOUT and STDERR write directly to the console, bypassing the buffers
+ * used by printf().
+ * @param fd File opened with OPEN_A, STDOUT or STDERR.
+ * @param buffer Data to write.
+ * @param size Number of bytes to write.
+ * @return Number of bytes written, EINVAL if @a fd is not opened for
+ * 	appending, ENOSPC if there is no space left, EIO on write error.
+ */
+int fwrite( file_t fd, const void* buffer, size_t size );
+
+/*!
+ * @brief Writes all cached data of the file to the disk.
+ * @param fd Opened file.
+ * @return EOK on success, EINVAL if @a fd is not opened, EIO on error.
+ */
+int fsync( file_t fd );
+
 int fseek( file_t fd, int pos, int offset );
 
+#include "iovec.h"
+
+/*!
+ * @brief Reads from the given position of the file.
+ *
+ * Position of the descriptor is neither used nor changed, so threads
+ * can read the same descriptor without seeking.
+ * @param fd Opened file.
+ * @param buffer Place to store the data.
+ * @param size Number of bytes to read.
+ * @param offset Position of the first byte.
+ * @return Number of bytes read (less at the end of the file),
+ * 	EINVAL if @a fd is not opened, EIO on read error.
+ */
+int pread( file_t fd, void* buffer, size_t size, size_t offset );
+
+/*!
+ * @brief Reads consecutive data into several buffers with one call.
+ *
+ * Buffers are filled in order from the current position, which is moved
+ * past the read data.
+ * @param fd Opened file.
+ * @param iov Buffers to fill.
+ * @param count Number of buffers, at most IOV_MAX.
+ * @return Total number of bytes read (less at the end of the file),
+ * 	EINVAL if @a fd is not opened or @a count is too large, EIO on error.
+ */
+int readv( file_t fd, const IOVEC* iov, uint count );
+
+/*!
+ * @brief Maps part of the file into the address space of the process.
+ *
+ * Nothing is read until the mapped memory is accessed, pages are loaded from
+ * the disk on the first touch. Mapping is read only and it is released
+ * by vma_free().
+ * @param fd Opened file.
+ * @param from Place where the address of the mapping will be stored.
+ * @param offset Offset of the first mapped byte in the file.
+ * @param size Size of the mapping, 0 maps the rest of the file. Resulting
+ * 	(page aligned) size is returned via this pointer.
+ * @retval EOK on success.
+ * @retval EINVAL if @a fd is not an opened file or @a offset is beyond its end.
+ * @retval ENOMEM if there is no space for the mapping.
+ */
+int fmmap( file_t fd, void** from, size_t offset, size_t* size );
+
+#include "aio.h"
+
+/*!
+ * @brief Prepares asynchronous read request (creates its event).
+ * @param request The request.
+ * @return EOK on success, ENOMEM if the event could not be created.
+ */
+int aio_init( AIO_READ* request );
+
+/*!
+ * @brief Starts reading the file, returns without waiting for the data.
+ *
+ * Fields @a fd, @a buffer, @a size and @a offset of the request describe
+ * the read, file position is neither used nor changed. The request and
+ * the buffer must not be touched until the read is finished, see
+ * aio_wait(). Several requests may be in flight at the same time.
+ * @param request Request prepared by aio_init().
+ * @retval EOK if the read was started.
+ * @retval EINVAL if @a fd is not an opened file.
+ * @retval ENOMEM if the request could not be queued.
+ */
+int fread_async( AIO_READ* request );
+
+/*!
+ * @brief Waits until the read started by fread_async() is finished.
+ * @param request The request.
+ * @return Number of bytes read (less than requested at the end of the
+ * 	file) or EIO.
+ */
+int aio_wait( AIO_READ* request );
+
+/*!
+ * @brief Destroys the event of the request, it must not be in flight.
+ * @param request The request.
+ * @return EOK on success.
+ */
+int aio_destroy( AIO_READ* request );
+
 int opendir( file_t* fd, const char* path );
 
 int closedir( file_t fd );
 
 int direntry( file_t dir_fd, DIR_ENTRY* entry );
 
+/* -------------------------------------------------------------------------- */
+/* -------------------------   BATCHED SYSCALLS   --------------------------- */
+/* -------------------------------------------------------------------------- */
+
+#include "syscallcodes.h"
+#include "submit.h"
+
+/*!
+ * @brief Queues a syscall to the submission ring of the process.
+ *
+ * Nothing is run until submit() is called. The ring is shared by all
+ * threads of the process, @a tag tells the results apart.
+ * @param code Syscall code (SYS_* constant), SYS_SUBMIT, SYS_EXIT and
+ * 	SYS_THREAD_EXIT are refused.
+ * @param p0 First syscall parameter.
+ * @param p1 Second syscall parameter.
+ * @param p2 Third syscall parameter.
+ * @param p3 Fourth syscall parameter.
+ * @param tag Value passed to the completion.
+ * @return EOK on success, EWOULDBLOCK if the ring is full.
+ */
+int submit_add( unsigned int code, unative_t p0, unative_t p1,
+	unative_t p2, unative_t p3, unative_t tag );
+
+/*!
+ * @brief Runs all queued syscalls with one kernel entry.
+ *
+ * Syscalls run in the order they were queued, blocking ones block the
+ * caller. Running stops early if there is no space for more results.
+ * @return Number of syscalls run.
+ */
+int submit();
+
+/*!
+ * @brief Gets the next result of the submitted syscalls.
+ *
+ * Results are read in submission order. A result of a syscall still
+ * blocked in another thread holds back the results behind it.
+ * @param tag Place to store the tag of the submission.
+ * @param result Place to store the return value of the syscall,
+ * 	EINVAL for an unknown syscall.
+ * @return EOK on success, EWOULDBLOCK if there is no result yet.
+ */
+int submit_reap( unative_t* tag, unative_t* result );
+
+/* -------------------------------------------------------------------------- */
+/* ----------------------------   ACCOUNTING   ------------------------------ */
+/* -------------------------------------------------------------------------- */
+
+#include "stat.h"
+
+/*!
+ * @brief Gets resource usage of a process.
+ *
+ * Process IDs are not reused, all processes are listed by starting at 0
+ * and asking for @a stat->pid + 1 next.
+ * @param proc ID of the process, the first living process with the same
+ * 	or higher ID is reported.
+ * @param stat Place to store the accounting.
+ * @return EOK on success, EINVAL if there is no such process.
+ */
+int process_stat( process_t proc, PROCESS_STAT* stat );
+
+/*!
+ * @brief Gets time accounting of a thread of the current process.
+ * @param thr ID of the thread.
+ * @param stat Place to store the accounting.
+ * @return EOK on success, EINVAL if there is no such thread.
+ */
+int thread_stat( thread_t thr, THREAD_STAT* stat );
+
+/* -------------------------------------------------------------------------- */
+/* -----------------------------   PROFILING   ------------------------------ */
+/* -------------------------------------------------------------------------- */
+
+#include "profile.h"
+
+/*!
+ * @brief Clears collected samples and starts the sampling profiler.
+ *
+ * The kernel samples the running code on timer interrupts, these come at
+ * least every @a usec microseconds while the profiler runs.
+ * @param usec Sampling interval, PROFILE_MIN_INTERVAL at least.
+ * @return EOK on success, EINVAL if the interval is too short.
+ */
+int profile_start( const unsigned int usec );
+
+/*! @brief Stops the sampling profiler, collected samples are kept. */
+void profile_stop();
+
+/*!
+ * @brief Prints the histogram of the collected samples to the console.
+ *
+ * Kernel addresses are resolved against kernel.map, user addresses
+ * against @a map, both looked up on the disk. Stops the profiler.
+ * @param map Map file of the profiled program, NULL for none.
+ * @return EOK on success, ENOMEM if the kernel is out of memory.
+ */
+int profile_dump( const char* map );
+
+/* -------------------------------------------------------------------------- */
+/* ------------------------------   TRACING   ------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+#include "trace.h"
+
+/*!
+ * @brief Sets the traced categories.
+ *
+ * The kernel keeps a ring of binary trace records, categories of
+ * tracepoints are listed in trace.h (TraceCategory).
+ * @param mask Mask of categories, 0 stops tracing.
+ * @return Previous mask.
+ */
+unsigned int trace_enable( const unsigned int mask );
+
+/*!
+ * @brief Takes the oldest trace records from the kernel ring.
+ * @param buffer Place to store the records.
+ * @param count Size of the buffer in records.
+ * @return Number of records stored, TRACE_LOST record comes first if
+ * 	the ring overflowed. EINVAL if the buffer is not valid.
+ */
+int trace_read( TRACE_RECORD* buffer, const unsigned int count );
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,51 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Sampling profiler constants shared by the kernel and librt.
+ */
+
+#pragma once
+
+#include "types.h"
+
+/*! @brief Shortest sampling interval in microseconds. */
+#define PROFILE_MIN_INTERVAL 100
+
+/*! @brief Commands of SYS_PROFILE. */
+enum ProfileCommand {
+	PROFILE_START,   /*!< Clear samples and start sampling.              */
+	PROFILE_STOP,    /*!< Stop sampling, samples are kept.               */
+	PROFILE_DUMP     /*!< Print the histogram of the samples.            */
+};
+
+/*! @brief One sample taken by the profiler. */
+typedef struct profile_sample
+{
+	unative_t epc;     /*!< Interrupted instruction.                     */
+	thread_t thread;   /*!< Running thread.                              */
+	unative_t asid;    /*!< Address space of the running thread.         */
+} PROFILE_SAMPLE;
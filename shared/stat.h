@@ -0,0 +1,69 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Resource accounting records shared by the kernel and librt.
+ */
+
+#pragma once
+
+#include "types.h"
+
+/*!
+ * @brief Accounting of one thread, see thread_stat().
+ *
+ * Times are in cycles of the CP0 Count register, measured at thread
+ * switches.
+ */
+typedef struct thread_stat
+{
+	uint64_t cpu_cycles;      /*!< Cycles spent running.               */
+	uint64_t wait_cycles;     /*!< Cycles spent ready or blocked.      */
+	uint voluntary;           /*!< Switches away by blocking or yield. */
+	uint involuntary;         /*!< Switches away by preemption.        */
+} THREAD_STAT;
+
+/*!
+ * @brief Accounting of one process, see process_stat().
+ */
+typedef struct process_stat
+{
+	process_t pid;            /*!< ID of the process.                  */
+	uint threads;             /*!< Number of threads.                  */
+	uint64_t cpu_cycles;      /*!< Cycles of all its threads, finished
+	                               ones included.                      */
+	uint cycles_per_usec;     /*!< Cycle counter frequency.            */
+	uint areas;               /*!< Number of virtual memory areas.     */
+	size_t resident;          /*!< Bytes of frames only it uses,
+	                               private file pages included.        */
+	size_t shared;            /*!< Bytes of file image frames it maps,
+	                               other processes might map them too. */
+	uint syscalls;            /*!< Number of syscall traps, a batch
+	                               counts once.                        */
+	uint tlb_refills;         /*!< Number of TLB refills.              */
+	uint64_t read_bytes;      /*!< Bytes read from files.              */
+	uint64_t written_bytes;   /*!< Bytes written to files.             */
+} PROCESS_STAT;
@@ -79,6 +79,12 @@ public:
 	 */
 	inline const HashMap<ID, T>& map() const;
 
+	/*!
+	 * @brief Gets the highest ID generated so far.
+	 * @return The last generated ID, BAD_ID if there was none.
+	 */
+	inline ID lastId() const;
+
 	/*!
 	 * @brief Standard destructor, clears hashmap.
 	 */
@@ -152,6 +158,12 @@ const HashMap<ID, T>& IdMap<ID, T>::map() const
 }
 /*----------------------------------------------------------------------------*/
 template <typename ID, typename T>
+ID IdMap<ID, T>::lastId() const
+{
+	return m_lastId;
+}
+/*----------------------------------------------------------------------------*/
+template <typename ID, typename T>
 IdMap<ID, T>::~IdMap()
 {
 	m_map.clear();
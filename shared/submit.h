@@ -0,0 +1,75 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Syscall submission ring shared by the kernel and librt.
+ */
+
+#pragma once
+
+#include "types.h"
+
+/*! @brief Number of entries in both parts of the ring. */
+#define SUBMIT_RING_SIZE 16
+
+/*!
+ * @brief Syscall waiting in the submission ring, see submit_add().
+ */
+typedef struct submit_entry
+{
+	volatile unative_t code;      /*!< Syscall code.                       */
+	volatile unative_t params[4]; /*!< Syscall parameters.                 */
+	volatile unative_t tag;       /*!< Copied to the completion.           */
+} SUBMIT_ENTRY;
+
+/*!
+ * @brief Result of a submitted syscall, see submit_reap().
+ */
+typedef struct completion_entry
+{
+	volatile unative_t tag;       /*!< Tag of the submitted entry.         */
+	volatile unative_t result;    /*!< Return value of the syscall.        */
+	volatile native_t ready;      /*!< Nonzero when the result is stored.  */
+} COMPLETION_ENTRY;
+
+/*!
+ * @brief Submission and completion ring of a process.
+ *
+ * All indices only grow, entry is at index % SUBMIT_RING_SIZE. librt
+ * writes submissions and moves @a sq_tail, kernel takes them moving
+ * @a sq_head. Kernel reserves a completion (moving @a cq_tail) when it
+ * takes a submission and sets its @a ready flag when the syscall
+ * returns, librt reads completions moving @a cq_head.
+ */
+typedef struct submit_ring
+{
+	volatile uint sq_head;        /*!< Next submission taken by kernel.    */
+	volatile uint sq_tail;        /*!< Next free submission.               */
+	volatile uint cq_head;        /*!< Next completion read by librt.      */
+	volatile uint cq_tail;        /*!< Next completion reserved by kernel. */
+	SUBMIT_ENTRY sq[SUBMIT_RING_SIZE];     /*!< Submissions.               */
+	COMPLETION_ENTRY cq[SUBMIT_RING_SIZE]; /*!< Completions.               */
+} SUBMIT_RING;
@@ -62,13 +62,30 @@
 #define SYS_PROC_CREATE    23
 #define SYS_PROC_JOIN      24
 #define SYS_PROC_KILL      25
+#define SYS_PROC_SPAWN     33
 
 #define SYS_FS_OPEN        26
 #define SYS_FS_CLOSE       27
 #define SYS_FS_READ        28
 #define SYS_FS_WRITE       29
+/*! Length based write, used with STDOUT/STDERR instead of SYS_PUTS. */
+#define SYS_WRITE          SYS_FS_WRITE
 #define SYS_FS_SEEK        30
 #define SYS_FS_ENTRY       31
+#define SYS_FS_MMAP        32
+#define SYS_FS_READ_ASYNC  34
+#define SYS_FS_PREAD       35
+#define SYS_FS_READV       36
+#define SYS_FS_SYNC        37
 
-#define SYS_COUNT          32
+#define SYS_NOP            38
+#define SYS_SUBMIT         39
+
+#define SYS_STAT_PROCESS   40
+#define SYS_STAT_THREAD    41
+
+#define SYS_PROFILE        42
+#define SYS_TRACE          43
+
+#define SYS_COUNT          44
 
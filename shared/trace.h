@@ -0,0 +1,108 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Tracepoint records shared by the kernel, librt and the host
+ * 	decoder (tools/tracedump.cpp).
+ *
+ * Only fixed size builtin types are used, the header is compiled by the
+ * host compiler as well.
+ */
+
+#pragma once
+
+/*! @brief Categories of tracepoints, enabled by trace_enable(). */
+enum TraceCategory {
+	TRACE_ALWAYS    = 0x00,  /*!< Records of the trace itself.           */
+	TRACE_SCHEDULER = 0x01,  /*!< Thread switches and run queue changes. */
+	TRACE_TLB       = 0x02,  /*!< TLB refills and modified exceptions.   */
+	TRACE_FRAMES    = 0x04,  /*!< Frame allocation and freeing.          */
+	TRACE_DISK      = 0x08,  /*!< Disk sector transfers.                 */
+	TRACE_SYSCALL   = 0x10,  /*!< Syscall entries and exits.             */
+	TRACE_TIMER     = 0x20,  /*!< Timer wakeups.                         */
+	TRACE_IRQ       = 0x40,  /*!< Interrupts.                            */
+	TRACE_ALL       = 0x7f
+};
+
+/*!
+ * @brief List of tracepoints: EVENT( id, category, name, arg0, arg1 ).
+ *
+ * Names are used by the decoder, an empty argument name means the
+ * argument is not used.
+ */
+#define TRACE_EVENTS(EVENT) \
+	EVENT( LOST,          ALWAYS,    "lost",          "records", "" ) \
+	EVENT( START,         ALWAYS,    "start",         "cycles_per_usec", "mask" ) \
+	EVENT( SWITCH,        SCHEDULER, "switch",        "from",    "to" ) \
+	EVENT( ENQUEUE,       SCHEDULER, "enqueue",       "thread",  "" ) \
+	EVENT( DEQUEUE,       SCHEDULER, "dequeue",       "thread",  "" ) \
+	EVENT( TLB_REFILL,    TLB,       "tlb_refill",    "address", "asid" ) \
+	EVENT( TLB_MODIFIED,  TLB,       "tlb_modified",  "address", "asid" ) \
+	EVENT( FRAME_ALLOC,   FRAMES,    "frame_alloc",   "address", "bytes" ) \
+	EVENT( FRAME_FREE,    FRAMES,    "frame_free",    "address", "bytes" ) \
+	EVENT( DISK_START,    DISK,      "disk_start",    "sector",  "write" ) \
+	EVENT( DISK_DONE,     DISK,      "disk_done",     "sector",  "failed" ) \
+	EVENT( SYSCALL_ENTER, SYSCALL,   "syscall_enter", "code",    "" ) \
+	EVENT( SYSCALL_EXIT,  SYSCALL,   "syscall_exit",  "code",    "result" ) \
+	EVENT( TIMER_WAKE,    TIMER,     "timer_wake",    "thread",  "" ) \
+	EVENT( INTERRUPT,     IRQ,       "interrupt",     "cause",   "epc" )
+
+#define TRACE_EVENT_ID( id, category, name, arg0, arg1 ) TRACE_##id,
+#define TRACE_EVENT_CATEGORY( id, category, name, arg0, arg1 ) \
+	TRACE_CATEGORY_##id = TRACE_##category,
+
+/*! @brief Tracepoint identifiers: TRACE_LOST, TRACE_SWITCH, ... */
+enum TraceEvent {
+	TRACE_EVENTS( TRACE_EVENT_ID )
+	TRACE_EVENT_COUNT
+};
+
+/*! @brief Category of each tracepoint: TRACE_CATEGORY_SWITCH, ... */
+enum TraceEventCategory {
+	TRACE_EVENTS( TRACE_EVENT_CATEGORY )
+};
+
+/*! @brief Commands of SYS_TRACE. */
+enum TraceCommand {
+	TRACE_COMMAND_ENABLE,    /*!< Set the mask of enabled categories. */
+	TRACE_COMMAND_READ       /*!< Take the oldest records.            */
+};
+
+/*! @brief One trace record, 16 bytes. */
+typedef struct trace_record
+{
+	unsigned int cycles;     /*!< CP0 Count when the record was taken. */
+	unsigned short event;    /*!< TraceEvent.                          */
+	unsigned short thread;   /*!< Running thread.                      */
+	unsigned int arg0;       /*!< Event specific.                      */
+	unsigned int arg1;       /*!< Event specific.                      */
+} TRACE_RECORD;
+
+/*!
+ * @brief Magic of a dump written by the init shell: the magic, the number
+ * 	of records (unsigned int) and the records follow.
+ */
+#define TRACE_DUMP_MAGIC "BTRACE01"
@@ -86,6 +86,10 @@ enum FilePos {
 	POS_START, POS_CURRENT, POS_END
 };
 
+/*! Standard output and error, never used as ids of opened files. */
+#define STDOUT ((file_t)-1)
+#define STDERR ((file_t)-2)
+
 
 /*----------------------------------------------------------------------------*/
 #ifndef NULL
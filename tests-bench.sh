@@ -0,0 +1,59 @@
+#! /bin/bash
+
+#
+# Compile and boot the benchmark suite (make bench) and store its results.
+# Every result is a line "<name> <value> <unit>" in the results file, when
+# results of an earlier run are given, both runs are compared.
+#
+# tests-bench.sh [-v] [results] [earlier results]
+#
+
+fail() {
+	rm -f bench.log
+	echo
+	echo "Failure: $1"
+	exit 1
+}
+
+# Don't output command executed by make unless run with -v
+if [ "$1" == "-v" ] ; then
+	SILENT_MAKE=""
+	shift
+else
+	SILENT_MAKE="--silent"
+fi
+
+RESULTS="${1:-bench-results.txt}"
+BASELINE="$2"
+
+emake() {
+	echo "Running make $SILENT_MAKE $@"
+	make $SILENT_MAKE "$@"
+}
+
+emake -j3 bench || fail "Compilation"
+msim | tee bench.log || fail "Execution"
+grep '^Test passed\.\.\.' bench.log > /dev/null || fail "Benchmarks did not finish"
+grep '^BENCH ' bench.log | tr -d '\r' | cut -d ' ' -f 2- > "$RESULTS"
+rm -f bench.log
+emake clean-apps
+
+echo
+echo "Results stored in $RESULTS"
+
+if [ -n "$BASELINE" ] ; then
+	echo
+	awk '
+		NR == FNR { old[$1] = $2; next }
+		{
+			if (!($1 in old)) {
+				printf "%-24s %12s %12s %8s %s\n", $1, "-", $2, "new", $3
+			} else if (old[$1] == 0) {
+				printf "%-24s %12s %12s %8s %s\n", $1, old[$1], $2, "-", $3
+			} else {
+				printf "%-24s %12s %12s %+7.1f%% %s\n", $1, old[$1], $2,
+					($2 - old[$1]) * 100 / old[$1], $3
+			}
+		}
+	' "$BASELINE" "$RESULTS"
+fi
@@ -0,0 +1,327 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Kernel part of the benchmark suite (make bench).
+ *
+ * Measures kernel primitives in cycles of the CP0 Count register: thread
+ * switch, frame and heap allocation, mutexes and semaphores with and
+ * without contention, event wake up latency, timer accuracy and
+ * sequential reads of the raw disk. Every result is one line
+ * "BENCH <name> <value> <unit>", tests-bench.sh collects and compares
+ * them. The user part (tests/bench/user) runs afterwards.
+ */
+
+#include <api.h>
+#include <Kernel.h>
+#include <drivers/Processor.h>
+#include <drivers/DiskDevice.h>
+#include <mem/FrameAllocator.h>
+#include <synchronization/Event.h>
+
+//number of thread switches
+const unsigned int SWITCHES = 2000;
+//number of uncontended lock/unlock or up/down pairs
+const unsigned int LOCKS = 10000;
+//number of critical sections of each contending thread
+const unsigned int CONTENDED = 500;
+//number of malloc/free pairs
+const unsigned int ALLOCS = 2000;
+//number of frames allocated at once
+const unsigned int FRAMES = 32;
+//number of frame batches
+const unsigned int FRAME_ROUNDS = 20;
+//number of event wake ups and timer events
+const unsigned int WAKEUPS = 50;
+const unsigned int TIMERS = 20;
+//timer delay
+const unsigned int TIMER_USECS = 10000;
+//bytes read from the disk and size of one read
+const unsigned int DISK_BYTES = 1024 * 1024;
+const unsigned int DISK_CHUNK = 8192;
+
+static inline uint cycles()
+{
+	return Processor::reg_read_count();
+}
+
+static void report( const char* name, uint value, const char* unit )
+{
+	printk( "BENCH %s %u %s\n", name, value, unit );
+}
+
+static thread_t start( void* (*func)(void*), void* data )
+{
+	thread_t thread;
+	if (thread_create( &thread, func, data, 0 ) != EOK) {
+		panic( "Failed to create benchmark thread.\n" );
+	}
+	return thread;
+}
+/*----------------------------------------------------------------------------*/
+static volatile bool switching;
+
+static void* yielder( void* data )
+{
+	while (switching)
+		thread_yield();
+	return NULL;
+}
+
+static void contextSwitch()
+{
+	switching = true;
+	thread_t partner = start( yielder, NULL );
+	thread_yield();
+
+	/* every yield switches to the partner and it switches back */
+	const uint begin = cycles();
+	for (uint i = 0; i < SWITCHES; ++i)
+		thread_yield();
+	const uint spent = cycles() - begin;
+
+	switching = false;
+	thread_join( partner );
+	report( "thread.switch", spent / (SWITCHES * 2), "cycles" );
+}
+/*----------------------------------------------------------------------------*/
+static void frames()
+{
+	void* frame[FRAMES];
+	uint alloc = 0, release = 0;
+	for (uint round = 0; round < FRAME_ROUNDS; ++round) {
+		const uint begin = cycles();
+		for (uint i = 0; i < FRAMES; ++i) {
+			if (!FrameAllocator::instance().allocateAtKseg0(
+			    &frame[i], 1, Processor::PAGE_MIN ))
+				panic( "Failed to allocate frame %u.\n", i );
+		}
+		const uint middle = cycles();
+		for (uint i = 0; i < FRAMES; ++i)
+			FrameAllocator::instance().frameFree(
+				frame[i], 1, Processor::PAGE_MIN );
+		alloc += middle - begin;
+		release += cycles() - middle;
+	}
+	report( "frame.alloc", alloc / (FRAMES * FRAME_ROUNDS), "cycles" );
+	report( "frame.free", release / (FRAMES * FRAME_ROUNDS), "cycles" );
+}
+/*----------------------------------------------------------------------------*/
+static void heap()
+{
+	const uint begin = cycles();
+	for (uint i = 0; i < ALLOCS; ++i) {
+		/* sizes from 16 to 1024 bytes */
+		void* block = malloc( 16 << (i % 7) );
+		if (!block)
+			panic( "Kernel malloc failed.\n" );
+		free( block );
+	}
+	report( "kmalloc.malloc_free", (cycles() - begin) / ALLOCS, "cycles" );
+}
+/*----------------------------------------------------------------------------*/
+static mutex_t mutex;
+
+static void* mutexWorker( void* data )
+{
+	for (uint i = 0; i < CONTENDED; ++i) {
+		mutex_lock( &mutex );
+		thread_yield();
+		mutex_unlock( &mutex );
+	}
+	return NULL;
+}
+
+static void mutexes()
+{
+	mutex_init( &mutex );
+
+	uint begin = cycles();
+	for (uint i = 0; i < LOCKS; ++i) {
+		mutex_lock( &mutex );
+		mutex_unlock( &mutex );
+	}
+	report( "mutex.uncontended", (cycles() - begin) / LOCKS, "cycles" );
+
+	/* holders yield inside the critical section, the other one blocks */
+	begin = cycles();
+	thread_t first = start( mutexWorker, NULL );
+	thread_t second = start( mutexWorker, NULL );
+	thread_join( first );
+	thread_join( second );
+	report( "mutex.contended", (cycles() - begin) / (CONTENDED * 2), "cycles" );
+
+	mutex_destroy( &mutex );
+}
+/*----------------------------------------------------------------------------*/
+static semaphore_t ping, pong;
+
+static void* pongWorker( void* data )
+{
+	for (uint i = 0; i < CONTENDED; ++i) {
+		sem_down( &ping );
+		sem_up( &pong );
+	}
+	return NULL;
+}
+
+static void semaphores()
+{
+	sem_init( &ping, 0 );
+	sem_init( &pong, 0 );
+
+	uint begin = cycles();
+	for (uint i = 0; i < LOCKS; ++i) {
+		sem_up( &ping );
+		sem_down( &ping );
+	}
+	report( "sem.uncontended", (cycles() - begin) / LOCKS, "cycles" );
+
+	/* every down blocks until the other thread gets to its up */
+	thread_t partner = start( pongWorker, NULL );
+	begin = cycles();
+	for (uint i = 0; i < CONTENDED; ++i) {
+		sem_up( &ping );
+		sem_down( &pong );
+	}
+	report( "sem.contended", (cycles() - begin) / (CONTENDED * 2), "cycles" );
+	thread_join( partner );
+
+	sem_destroy( &ping );
+	sem_destroy( &pong );
+}
+/*----------------------------------------------------------------------------*/
+static Event* event;
+static volatile uint woken;
+
+static void* eventWaiter( void* data )
+{
+	event->wait();
+	woken = cycles();
+	return NULL;
+}
+
+static void events()
+{
+	event = new Event();
+	uint total = 0, worst = 0;
+	for (uint i = 0; i < WAKEUPS; ++i) {
+		thread_t waiter = start( eventWaiter, NULL );
+		while (!event->waiting())
+			thread_yield();
+
+		const uint fired = cycles();
+		event->fire();
+		thread_join( waiter );
+
+		const uint latency = woken - fired;
+		total += latency;
+		if (latency > worst)
+			worst = latency;
+	}
+	delete event;
+	report( "event.wake", total / WAKEUPS, "cycles" );
+	report( "event.wake_max", worst, "cycles" );
+}
+/*----------------------------------------------------------------------------*/
+static volatile uint expired;
+
+static void timerHandler( struct timer* tmr, void* data )
+{
+	expired = cycles();
+	sem_up( (semaphore_t*)data );
+}
+
+static void timers()
+{
+	semaphore_t done;
+	sem_init( &done, 0 );
+	struct timer tmr;
+
+	const uint per_usec = KERNEL.cyclesPerUsec();
+	uint total = 0, worst = 0;
+	for (uint i = 0; i < TIMERS; ++i) {
+		timer_init( &tmr, TIMER_USECS, timerHandler, &done );
+		const uint begin = cycles();
+		timer_start( &tmr );
+		sem_down( &done );
+
+		/* the timer can fire a bit early if the clock and Count differ */
+		const uint took = (expired - begin) / per_usec;
+		const uint late = (took > TIMER_USECS) ? took - TIMER_USECS : 0;
+		total += late;
+		if (late > worst)
+			worst = late;
+		timer_destroy( &tmr );
+	}
+	sem_destroy( &done );
+	report( "timer.late", total / TIMERS, "usecs" );
+	report( "timer.late_max", worst, "usecs" );
+}
+/*----------------------------------------------------------------------------*/
+static void disk()
+{
+	/* the device itself, the block cache and the RAM disk would serve
+	 * the data TarFS has already read from memory */
+	DiskDevice* device = KERNEL.rawDisk();
+	if (!device) {
+		printk( "No disk, skipping disk benchmark.\n" );
+		return;
+	}
+	const uint size = device->size();
+	const uint bytes = (size < DISK_BYTES) ? size - size % DISK_CHUNK : DISK_BYTES;
+	char* buffer = (char*)malloc( DISK_CHUNK );
+	if (!buffer || !bytes)
+		panic( "Nothing to read the disk into.\n" );
+
+	const Time begin = Time::getCurrentTime();
+	for (uint pos = 0; pos < bytes; pos += DISK_CHUNK) {
+		if (!device->read( buffer, DISK_CHUNK, pos / BLOCK_SIZE, 0 ))
+			panic( "Failed to read disk at %u.\n", pos );
+	}
+	const uint usecs = (Time::getCurrentTime() - begin).toUsecs();
+	free( buffer );
+
+	/* bytes per msec are KB/s, bytes * 1000 fits 32 bits for 1MB */
+	report( "disk.read_seq", usecs ? (bytes * 1000) / usecs : 0, "KB/s" );
+}
+/*----------------------------------------------------------------------------*/
+void run_test()
+{
+	printk( "Kernel benchmarks...\n" );
+	report( "cpu.frequency", KERNEL.cyclesPerUsec(), "MHz" );
+
+	contextSwitch();
+	frames();
+	heap();
+	mutexes();
+	semaphores();
+	events();
+	timers();
+	disk();
+
+	printk( "Kernel benchmarks done.\n" );
+}
@@ -0,0 +1,188 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief User part of the benchmark suite (make bench).
+ *
+ * Runs after the kernel part (tests/bench/kernel) and measures what only
+ * a process sees: the null syscall, batched syscalls, reading the clock
+ * without a syscall, TLB refills and process spawn. Results use the same
+ * "BENCH <name> <value> <unit>" lines.
+ */
+
+#include "librt.h"
+#include "Time.h"
+
+//number of calls of each syscall
+const unsigned int CALLS = 10000;
+//number of separate 8 KB areas touched by the TLB benchmark
+const unsigned int AREAS = 256;
+//number of memory accesses of the TLB benchmark
+const unsigned int ACCESSES = AREAS * 40;
+//number of spawned processes
+const unsigned int SPAWNS = 10;
+
+static uint cycles_per_usec = 1;
+
+static void report(const char* name, uint value, const char* unit)
+{
+	printf("BENCH %s %u %s\n", name, value, unit);
+}
+
+static Time now()
+{
+	return Time::getCurrent();
+}
+
+static uint usecs_since(const Time& start)
+{
+	return (now() - start).toUsecs();
+}
+
+/*! Converts usecs spent by count operations to cycles per operation. */
+static uint cycles_per_op(uint usecs, uint count)
+{
+	if (!count)
+		return 0;
+	if (usecs > (uint)-1 / cycles_per_usec)
+		return (usecs / count) * cycles_per_usec;
+	return usecs * cycles_per_usec / count;
+}
+
+static uint tlb_refills()
+{
+	PROCESS_STAT st;
+	if (process_stat(process_self(), &st) != EOK) {
+		panic("Failed to get process accounting.\n");
+	}
+	return st.tlb_refills;
+}
+/*----------------------------------------------------------------------------*/
+static void syscalls()
+{
+	Time start = now();
+	for (uint i = 0; i < CALLS; ++i) {
+		if (syscall_nop() != EOK) {
+			panic("Null syscall failed.\n");
+		}
+	}
+	report("syscall.null", cycles_per_op(usecs_since(start), CALLS), "cycles");
+
+	start = now();
+	for (uint i = 0; i < CALLS; i += SUBMIT_RING_SIZE) {
+		for (uint j = 0; j < SUBMIT_RING_SIZE; ++j) {
+			submit_add(SYS_NOP, 0, 0, 0, 0, j);
+		}
+		submit();
+		for (uint j = 0; j < SUBMIT_RING_SIZE; ++j) {
+			if (submit_reap(NULL, NULL) != EOK) {
+				panic("Missing result of a batched syscall.\n");
+			}
+		}
+	}
+	report("syscall.batched", cycles_per_op(usecs_since(start), CALLS),
+		"cycles");
+
+	start = now();
+	for (uint i = 0; i < CALLS; ++i) {
+		Time::getCoarseTime();
+	}
+	report("clock.read", cycles_per_op(usecs_since(start), CALLS), "cycles");
+}
+/*----------------------------------------------------------------------------*/
+static volatile char* areas[AREAS];
+
+static uint touch(uint stride)
+{
+	const Time start = now();
+	for (uint i = 0; i < ACCESSES; ++i) {
+		++*areas[(i * stride) % AREAS];
+	}
+	return usecs_since(start);
+}
+
+static void tlb()
+{
+	for (uint i = 0; i < AREAS; ++i) {
+		void* area = NULL;
+		size_t size = 8192;
+		if (vma_alloc(&area, &size) != EOK) {
+			panic("Failed to allocate area %u.\n", i);
+		}
+		areas[i] = (volatile char*)area;
+		*areas[i] = 0;
+	}
+
+	/* the same entry over and over, then more pages than the TLB holds */
+	uint refills = tlb_refills();
+	const uint hot = touch(0);
+	const uint hot_refills = tlb_refills() - refills;
+	refills = tlb_refills();
+	const uint cold = touch(1);
+	const uint cold_refills = tlb_refills() - refills;
+
+	/* switches and timer interrupts might flush entries of the hot loop */
+	report("tlb.refill", cycles_per_op(cold > hot ? cold - hot : 0,
+		cold_refills > hot_refills ? cold_refills - hot_refills : 0), "cycles");
+	report("tlb.refills", cold_refills, "count");
+
+	for (uint i = 0; i < AREAS; ++i) {
+		vma_free((void*)areas[i]);
+	}
+}
+/*----------------------------------------------------------------------------*/
+static void spawn()
+{
+	uint started = 0, finished = 0;
+	for (uint i = 0; i < SPAWNS; ++i) {
+		process_t pid;
+		const Time start = now();
+		if (process_spawn(&pid, "child.bin") != EOK) {
+			panic("Failed to spawn child.bin.\n");
+		}
+		started += usecs_since(start);
+		process_join(pid);
+		finished += usecs_since(start);
+	}
+	report("process.spawn", started / SPAWNS, "usecs");
+	report("process.spawn_exit", finished / SPAWNS, "usecs");
+}
+/*----------------------------------------------------------------------------*/
+void
+main (void)
+{
+	PROCESS_STAT st;
+	if (process_stat(process_self(), &st) == EOK && st.cycles_per_usec) {
+		cycles_per_usec = st.cycles_per_usec;
+	}
+
+	printf("User benchmarks...\n");
+	syscalls();
+	tlb();
+	spawn();
+
+	printf("Test passed...\n");
+}
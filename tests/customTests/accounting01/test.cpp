@@ -0,0 +1,174 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+/*!
+ * @file
+ * @brief Process and thread accounting test.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+
+static const char * desc =
+	"Process and thread accounting test.\n"
+	"Test will make syscalls, read a file, yield, sleep and spin and "
+	"check that process_stat() and thread_stat() counters follow. Then "
+	"it will list all processes the way 'top' does.\n\n";
+
+//number of null syscalls
+const unsigned int CALLS = 100;
+
+//number of yields
+const unsigned int YIELDS = 10;
+
+//size of the read
+const size_t CHUNK = 1000;
+
+static const char * image = "data64k0.dat";
+
+static volatile bool stop = false;
+
+static PROCESS_STAT get_process()
+{
+	PROCESS_STAT st;
+	if (process_stat(process_self(), &st) != EOK || st.pid != process_self()) {
+		panic("Failed to get own accounting.\n");
+	}
+	return st;
+}
+
+static THREAD_STAT get_thread(thread_t thr)
+{
+	THREAD_STAT st;
+	if (thread_stat(thr, &st) != EOK) {
+		panic("Failed to get accounting of thread %u.\n", thr);
+	}
+	return st;
+}
+
+static void* spinner(void*)
+{
+	while (!stop) ;
+	return NULL;
+}
+
+static void check_process()
+{
+	const PROCESS_STAT before = get_process();
+	/* running code is in pages of the program image */
+	if (before.threads != 1 || before.areas == 0 || before.resident == 0
+	    || before.shared == 0 || before.cycles_per_usec == 0) {
+		panic("Wrong initial accounting: %u threads, %u areas, %u bytes, "
+			"%u bytes shared.\n", before.threads, before.areas,
+			before.resident, before.shared);
+	}
+
+	for (uint i = 0; i < CALLS; ++i) {
+		syscall_nop();
+	}
+	const PROCESS_STAT after_calls = get_process();
+	/* process_stat() itself is a syscall */
+	if (after_calls.syscalls != before.syscalls + CALLS + 1) {
+		panic("%u syscalls counted instead of %u.\n",
+			after_calls.syscalls - before.syscalls, CALLS + 1);
+	}
+	if (after_calls.cpu_cycles <= before.cpu_cycles) {
+		panic("CPU time did not grow.\n");
+	}
+
+	file_t fd;
+	char buffer[CHUNK];
+	if (fopen(&fd, image, OPEN_R) != EOK) {
+		panic("Failed to open %s.\n", image);
+	}
+	const int res = fread(fd, buffer, CHUNK);
+	fclose(fd);
+	const PROCESS_STAT after_read = get_process();
+	if (res <= 0 || after_read.read_bytes != before.read_bytes + res) {
+		panic("Read of %d bytes counted as %u.\n", res,
+			(uint)(after_read.read_bytes - before.read_bytes));
+	}
+}
+
+static void check_thread()
+{
+	const thread_t self = thread_self();
+	const THREAD_STAT before = get_thread(self);
+
+	for (uint i = 0; i < YIELDS; ++i) {
+		thread_yield();
+	}
+	thread_usleep(20000);
+	const THREAD_STAT after = get_thread(self);
+	if (after.voluntary < before.voluntary + 1) {
+		panic("Voluntary switches did not grow.\n");
+	}
+	if (after.wait_cycles <= before.wait_cycles) {
+		panic("Wait time did not grow during sleep.\n");
+	}
+
+	thread_t thr;
+	if (thread_create(&thr, spinner, NULL) != EOK) {
+		panic("Failed to create thread.\n");
+	}
+	if (get_process().threads != 2) {
+		panic("New thread not counted.\n");
+	}
+	/* the spinner runs out its quanta while I sleep */
+	thread_usleep(100000);
+	const THREAD_STAT spun = get_thread(thr);
+	if (spun.cpu_cycles == 0 || spun.involuntary == 0) {
+		panic("Spinning thread: %u involuntary switches, no CPU time.\n",
+			spun.involuntary);
+	}
+	stop = true;
+	thread_join(thr, NULL);
+}
+
+static void list_processes()
+{
+	bool found = false;
+	PROCESS_STAT st;
+	for (process_t pid = 0; process_stat(pid, &st) == EOK; pid = st.pid + 1) {
+		printf("process %u: %u threads, %u syscalls, %u TLB refills, "
+			"%u areas, %u KB, %u KB shared\n", st.pid, st.threads, st.syscalls,
+			st.tlb_refills, st.areas, st.resident >> 10, st.shared >> 10);
+		found = found || st.pid == process_self();
+	}
+	if (!found) {
+		panic("Own process is not listed.\n");
+	}
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	check_process();
+	check_thread();
+	list_processes();
+
+	printf("Test passed...\n");
+}
@@ -0,0 +1,147 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Appending to the log file test.
+ *
+ * Appends lines to results.log (the last file on the disk), checks that
+ * they can be read back by another descriptor and measures how long
+ * appends take with the write-back cache and with fsync() after each one.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"Log append test.\n"
+	"Test will append LINES lines to results.log, read them back using "
+	"another descriptor, check that read-only files refuse appending and "
+	"report average time of one append without and with fsync().\n\n";
+
+//number of lines appended in each round
+#define LINES 50
+
+//length of one line
+#define LINE_LENGTH 32
+
+static const char * log_name = "results.log";
+
+static const char * image = "test.bin";
+
+/* line "appendLog01 <round> <number>" padded by dots */
+static void make_line(char* line, uint round, uint number)
+{
+	for (uint i = 0; i < LINE_LENGTH; ++i)
+		line[i] = '.';
+	const char prefix[] = "appendLog01 ";
+	for (uint i = 0; i < sizeof(prefix) - 1; ++i)
+		line[i] = prefix[i];
+	line[12] = '0' + round;
+	line[13] = ' ';
+	for (uint i = 0, n = number; i < 4; ++i, n /= 10)
+		line[17 - i] = '0' + n % 10;
+	line[LINE_LENGTH - 1] = '\n';
+}
+
+static uint append_lines(file_t fd, uint round, bool sync)
+{
+	char line[LINE_LENGTH];
+	const Time start = Time::getCurrent();
+	for (uint i = 0; i < LINES; ++i) {
+		make_line(line, round, i);
+		const int res = fwrite(fd, line, LINE_LENGTH);
+		if (res != LINE_LENGTH) {
+			panic("Append of line %u returned %d.\n", i, res);
+		}
+		if (sync && fsync(fd) != EOK) {
+			panic("Failed to sync line %u.\n", i);
+		}
+	}
+	return (Time::getCurrent() - start).toUsecs() / LINES;
+}
+
+static void check_lines(file_t fd, size_t pos, uint round)
+{
+	char line[LINE_LENGTH], expected[LINE_LENGTH];
+	for (uint i = 0; i < LINES; ++i, pos += LINE_LENGTH) {
+		if (pread(fd, line, LINE_LENGTH, pos) != LINE_LENGTH) {
+			panic("Failed to read line %u of round %u.\n", i, round);
+		}
+		make_line(expected, round, i);
+		for (uint j = 0; j < LINE_LENGTH; ++j) {
+			if (line[j] != expected[j]) {
+				panic("Line %u of round %u differs at %u.\n", i, round, j);
+			}
+		}
+	}
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	file_t fd, ro_fd;
+	if (fopen(&ro_fd, image, OPEN_R) != EOK) {
+		panic("Failed to open %s.\n", image);
+	}
+	if (fopen(&fd, image, OPEN_A) == EOK) {
+		panic("%s is not the last file, but can be appended to.\n", image);
+	}
+	char dummy = 0;
+	if (fwrite(ro_fd, &dummy, 1) >= 0) {
+		panic("Descriptor opened for reading accepted a write.\n");
+	}
+	fclose(ro_fd);
+
+	if (fopen(&fd, log_name, OPEN_R | OPEN_A) != EOK) {
+		panic("Failed to open %s for appending.\n", log_name);
+	}
+	if (fopen(&ro_fd, log_name, OPEN_R) != EOK) {
+		panic("Failed to open %s.\n", log_name);
+	}
+
+	/* the log keeps data of the previous runs */
+	const size_t start = fseek(fd, POS_END, 0);
+	printf("%s has %u bytes.\n", log_name, start);
+
+	const uint cached = append_lines(fd, 1, false);
+	if (fsync(fd) != EOK) {
+		panic("Failed to sync %s.\n", log_name);
+	}
+	const uint synced = append_lines(fd, 2, true);
+
+	check_lines(ro_fd, start, 1);
+	check_lines(ro_fd, start + LINES * LINE_LENGTH, 2);
+
+	printf("append: %u usecs, append + fsync: %u usecs\n", cached, synced);
+
+	fclose(ro_fd);
+	fclose(fd);
+
+	printf("Test passed...\n");
+}
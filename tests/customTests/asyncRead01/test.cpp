@@ -0,0 +1,168 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Asynchronous read test.
+ *
+ * Keeps IN_FLIGHT asynchronous reads running while checksumming the data
+ * of the finished ones, the result has to match the synchronous read.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+#include "tools.h"
+
+static const char * desc =
+	"Asynchronous read test.\n"
+	"Test will checksum data200k.dat read by fread() and read by IN_FLIGHT "
+	"concurrent fread_async() requests, and compare results and times. "
+	"Reads to invalid buffers have to be refused.\n\n";
+
+//number of requests in flight
+#define IN_FLIGHT 4
+
+//size of one read
+const size_t CHUNK = 8192;
+
+static const char * image = "data200k.dat";
+
+static char buffers[IN_FLIGHT][CHUNK];
+
+static uint checksum(uint sum, const char* data, int size)
+{
+	for (int i = 0; i < size; ++i)
+		sum = sum * 31 + data[i];
+	return sum;
+}
+
+static uint readSync(file_t fd)
+{
+	uint sum = 0;
+	int res;
+	fseek(fd, POS_START, 0);
+	while ((res = fread(fd, buffers[0], CHUNK)) > 0)
+		sum = checksum(sum, buffers[0], res);
+	if (res < 0) {
+		panic("Failed to read %s: %d.\n", image, res);
+	}
+	return sum;
+}
+
+static uint readAsync(file_t fd, size_t size)
+{
+	AIO_READ requests[IN_FLIGHT];
+	size_t next = 0;
+	for (uint i = 0; i < IN_FLIGHT; ++i) {
+		if (aio_init(&requests[i]) != EOK) {
+			panic("Failed to init request %u.\n", i);
+		}
+		requests[i].fd = fd;
+		requests[i].buffer = buffers[i];
+		requests[i].size = CHUNK;
+		requests[i].offset = next;
+		if (fread_async(&requests[i]) != EOK) {
+			panic("Failed to start read at %u.\n", next);
+		}
+		next += CHUNK;
+	}
+
+	/* wait for the requests in the order of their offsets */
+	uint sum = 0;
+	for (size_t pos = 0; pos < size; pos += CHUNK) {
+		AIO_READ& request = requests[(pos / CHUNK) % IN_FLIGHT];
+		const int res = aio_wait(&request);
+		if (res < 0 || (size_t)res != min(CHUNK, size - pos)) {
+			panic("Read at %u returned %d.\n", pos, res);
+		}
+		sum = checksum(sum, (char*)request.buffer, res);
+
+		if (next < size) {
+			request.offset = next;
+			if (fread_async(&request) != EOK) {
+				panic("Failed to start read at %u.\n", next);
+			}
+			next += CHUNK;
+		}
+	}
+
+	for (uint i = 0; i < IN_FLIGHT; ++i)
+		aio_destroy(&requests[i]);
+	return sum;
+}
+
+static void checkInvalid(file_t fd)
+{
+	/* unmapped and kernel buffers are refused before queuing */
+	void* bad[] = { (void*)0x10, (void*)0x80000000 };
+	AIO_READ request;
+	if (aio_init(&request) != EOK) {
+		panic("Failed to init request.\n");
+	}
+	request.fd = fd;
+	request.size = CHUNK;
+	request.offset = 0;
+	for (uint i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+		request.buffer = bad[i];
+		const int res = fread_async(&request);
+		if (res != EINVAL) {
+			panic("Read to %p returned %d, expected EINVAL.\n", bad[i], res);
+		}
+	}
+	aio_destroy(&request);
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	file_t fd;
+	if (fopen(&fd, image, OPEN_R) != EOK) {
+		panic("Failed to open %s.\n", image);
+	}
+	const size_t size = fseek(fd, POS_END, 0);
+	checkInvalid(fd);
+
+	Time start = Time::getCurrent();
+	const uint expected = readSync(fd);
+	const uint sync_time = (Time::getCurrent() - start).toUsecs();
+
+	start = Time::getCurrent();
+	const uint sum = readAsync(fd, size);
+	const uint async_time = (Time::getCurrent() - start).toUsecs();
+	fclose(fd);
+
+	if (sum != expected) {
+		panic("Checksum differs: %x, expected %x.\n", sum, expected);
+	}
+
+	printf("results: %s (%u B, checksum %x)\n", image, size, sum);
+	printf("fread:       %u usecs\n", sync_time);
+	printf("fread_async: %u usecs\n", async_time);
+
+	printf("Test passed...\n");
+}
@@ -0,0 +1,96 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Block cache benchmark.
+ *
+ * Reads the same file several times, the first read has to go to the disk,
+ * the following ones should be served by the kernel block cache.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+#include "tools.h"
+
+static const char * desc =
+	"Block cache benchmark.\n"
+	"Test will read data200k.dat ROUNDS times in CHUNK sized pieces and "
+	"compare the time of "
+	"the first (cold) read with the average time of the others.\n\n";
+
+//number of reads of the file
+const unsigned int ROUNDS = 5;
+
+//size of one read, large reads would bypass the cache
+const size_t CHUNK = 8192;
+
+//file that is never executed, so nothing has read it yet
+static const char * image = "data200k.dat";
+
+static uint read_file(file_t fd, void* buffer, size_t size)
+{
+	fseek(fd, POS_START, 0);
+	const Time start = Time::getCurrent();
+	for (size_t pos = 0; pos < size; pos += CHUNK) {
+		const int res = fread(fd, (char*)buffer + pos, min(CHUNK, size - pos));
+		if (res < 0) {
+			panic("Failed to read %s: %d.\n", image, res);
+		}
+	}
+	return (Time::getCurrent() - start).toUsecs();
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	file_t fd;
+	if (fopen(&fd, image, OPEN_R) != EOK) {
+		panic("Failed to open %s.\n", image);
+	}
+
+	const size_t size = fseek(fd, POS_END, 0);
+	void* buffer = malloc(size);
+	if (!buffer) {
+		panic("Not enough memory for %u bytes.\n", size);
+	}
+
+	const uint cold = read_file(fd, buffer, size);
+	uint warm = 0;
+	for (unsigned int i = 1; i < ROUNDS; ++i)
+		warm += read_file(fd, buffer, size);
+
+	free(buffer);
+	fclose(fd);
+
+	printf("results: %s (%u B)\n", image, size);
+	printf("cold: %u usecs\n", cold);
+	printf("warm: %u usecs\n", warm / (ROUNDS - 1));
+
+	printf("Test passed...\n");
+}
@@ -0,0 +1,59 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Buffered console output test.
+ *
+ * Prints many lines quickly, user output waits for space in the kernel
+ * log buffer, so no line may be lost.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"Console flood test.\n"
+	"Test will print LINES lines as fast as it can and report average "
+	"time of one printf(). All lines have to show up.\n\n";
+
+//number of printed lines
+#define LINES 400
+
+void
+main (void)
+{
+	printf(desc);
+
+	const Time start = Time::getCurrent();
+	for (uint i = 0; i < LINES; ++i) {
+		printf("consoleFlood01: line %u of %u\n", i, LINES);
+	}
+	const uint usecs = (Time::getCurrent() - start).toUsecs();
+
+	printf("printf: %u usecs per line\n", usecs / LINES);
+	printf("Test passed...\n");
+}
@@ -0,0 +1,121 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Concurrent disk readers test.
+ *
+ * Several threads read different files at the same time, their requests
+ * meet in the disk queue. Data read concurrently have to match the data
+ * read by a single reader.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"Concurrent disk readers test.\n"
+	"Test will checksum data64k0.dat - data64k3.dat one after another, "
+	"then by READERS threads at the same time, and compare the results "
+	"and times.\n\n";
+
+//number of files and concurrent readers
+#define READERS 4
+
+//size of one read
+const size_t CHUNK = 4096;
+
+static const char * images[READERS] =
+	{ "data64k0.dat", "data64k1.dat", "data64k2.dat", "data64k3.dat" };
+
+static char buffers[READERS][CHUNK];
+
+static uint sums[READERS];
+
+static void* reader(void* data)
+{
+	const uint id = (uint)data;
+
+	file_t fd;
+	if (fopen(&fd, images[id], OPEN_R) != EOK) {
+		panic("Failed to open %s.\n", images[id]);
+	}
+
+	uint sum = 0;
+	int res;
+	while ((res = fread(fd, buffers[id], CHUNK)) > 0) {
+		for (int i = 0; i < res; ++i)
+			sum = sum * 31 + buffers[id][i];
+	}
+	if (res < 0) {
+		panic("Failed to read %s: %d.\n", images[id], res);
+	}
+	fclose(fd);
+
+	sums[id] = sum;
+	return NULL;
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	uint expected[READERS];
+	Time start = Time::getCurrent();
+	for (uint i = 0; i < READERS; ++i) {
+		reader((void*)i);
+		expected[i] = sums[i];
+		sums[i] = 0;
+	}
+	const uint sequential = (Time::getCurrent() - start).toUsecs();
+
+	thread_t threads[READERS];
+	start = Time::getCurrent();
+	for (uint i = 0; i < READERS; ++i) {
+		if (thread_create(&threads[i], reader, (void*)i) != EOK) {
+			panic("Failed to create reader %u.\n", i);
+		}
+	}
+	for (uint i = 0; i < READERS; ++i) {
+		if (thread_join(threads[i], NULL) != EOK) {
+			panic("Failed to join reader %u.\n", i);
+		}
+	}
+	const uint concurrent = (Time::getCurrent() - start).toUsecs();
+
+	for (uint i = 0; i < READERS; ++i) {
+		if (sums[i] != expected[i]) {
+			panic("Checksum of %s differs: %x, expected %x.\n",
+				images[i], sums[i], expected[i]);
+		}
+	}
+
+	printf("sequential: %u usecs\n", sequential);
+	printf("concurrent: %u usecs\n", concurrent);
+
+	printf("Test passed...\n");
+}
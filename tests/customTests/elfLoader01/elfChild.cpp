@@ -0,0 +1,66 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Program started by the ELF loader test.
+ *
+ * Checks initial values of its data and bss and overwrites them.
+ */
+
+#include "librt.h"
+
+/* stored in the executable, private to every instance */
+volatile unsigned int counter = 0x600d;
+
+/* not stored in the executable, zero filled when touched */
+volatile char zeroed[64 * 1024];
+
+static const char * message = "ELF child: text and rodata are readable.\n";
+
+int main()
+{
+	printf(message);
+
+	if (counter != 0x600d) {
+		printf("ELF child: data not initialized (%x), FAILED.\n", counter);
+		return 1;
+	}
+
+	for (unsigned int i = 0; i < sizeof(zeroed); ++i) {
+		if (zeroed[i] != 0) {
+			printf("ELF child: bss not zeroed at %u, FAILED.\n", i);
+			return 1;
+		}
+	}
+
+	/* the next instance must not see these */
+	counter = 0xbad;
+	for (unsigned int i = 0; i < sizeof(zeroed); ++i)
+		zeroed[i] = (char)i | 1;
+
+	printf("ELF child: data and bss are private, OK.\n");
+	return 0;
+}
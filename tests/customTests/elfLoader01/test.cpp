@@ -0,0 +1,91 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief ELF loader test.
+ *
+ * Starts the same executable several times, both from the file and from
+ * a memory buffer. Every instance checks that its data and bss start with
+ * the values from the executable and then overwrites them, so changes that
+ * leak between instances are reported by the next one.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+
+static const char * desc =
+	"ELF loader test.\n"
+	"Test will start elfChild.bin ROUNDS times using process_spawn() and "
+	"ROUNDS times using process_create(), every child writes its data and "
+	"bss and reports whether it found them intact.\n\n";
+
+//number of processes started by each method
+const unsigned int ROUNDS = 3;
+
+static const char * image = "elfChild.bin";
+
+static int create_buffered(process_t* pid, const char* name)
+{
+	file_t fd;
+	if (fopen(&fd, name, OPEN_R) != EOK)
+		return EIO;
+
+	const size_t size = fseek(fd, POS_END, 0);
+	fseek(fd, POS_START, 0);
+
+	void* buffer = malloc(size);
+	if (!buffer) {
+		fclose(fd);
+		return ENOMEM;
+	}
+
+	int res = fread(fd, buffer, size);
+	fclose(fd);
+	if (res >= 0)
+		res = process_create(pid, buffer, size);
+	free(buffer);
+	return res;
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	for (unsigned int i = 0; i < 2 * ROUNDS; ++i) {
+		const bool spawn = i < ROUNDS;
+		process_t pid;
+		const int res = spawn ?
+			process_spawn(&pid, image) : create_buffered(&pid, image);
+		if (res != EOK) {
+			panic("Failed to start %s (%s): %d.\n",
+				image, spawn ? "spawn" : "create", res);
+		}
+		process_join(pid);
+	}
+
+	printf("Test passed...\n");
+}
@@ -0,0 +1,96 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Disk read throughput benchmark.
+ *
+ * Reads a large file into user memory once with a single fread() (whole
+ * sectors go straight from the disk to the user frames) and once in pieces
+ * that are not sector aligned (sectors go through the kernel buffers).
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"Disk read throughput benchmark.\n"
+	"Test will read data400k.dat using one large fread() and using "
+	"fread() of SMALL bytes, and report throughput of both.\n\n";
+
+//size of the unaligned reads
+const size_t SMALL = 500;
+
+static const char * image = "data400k.dat";
+
+static void report(const char* name, size_t size, uint usecs)
+{
+	if (!usecs) usecs = 1;
+	/* bytes per usec is MB/s, keep two decimals */
+	const uint rate = (uint)((unsigned long long)size * 100 / usecs);
+	printf("%s %u.%02u MB/s (%u B in %u usecs)\n",
+		name, rate / 100, rate % 100, size, usecs);
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	file_t fd;
+	if (fopen(&fd, image, OPEN_R) != EOK) {
+		panic("Failed to open %s.\n", image);
+	}
+
+	const size_t size = fseek(fd, POS_END, 0);
+	char* buffer = (char*)malloc(size);
+	if (!buffer) {
+		panic("Not enough memory for %u bytes.\n", size);
+	}
+
+	fseek(fd, POS_START, 0);
+	Time start = Time::getCurrent();
+	if (fread(fd, buffer, size) != (int)size) {
+		panic("Failed to read %s.\n", image);
+	}
+	report("large:", size, (Time::getCurrent() - start).toUsecs());
+
+	fseek(fd, POS_START, 0);
+	start = Time::getCurrent();
+	for (size_t pos = 0; pos < size; ) {
+		const int res = fread(fd, buffer + pos, SMALL);
+		if (res <= 0) {
+			panic("Failed to read %s: %d.\n", image, res);
+		}
+		pos += res;
+	}
+	report("small:", size, (Time::getCurrent() - start).toUsecs());
+
+	free(buffer);
+	fclose(fd);
+
+	printf("Test passed...\n");
+}
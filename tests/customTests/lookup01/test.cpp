@@ -0,0 +1,122 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief TarFS name lookup test.
+ *
+ * Opens files by several forms of their path, lists the root directory
+ * and measures fopen() latency of found and missing names.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"TarFS lookup test.\n"
+	"Test will open test.bin using different paths, check that missing "
+	"names and files used as directories are not found, list the root "
+	"directory and report average fopen() time over ROUNDS rounds.\n\n";
+
+//number of measured opens
+#define ROUNDS 200
+
+static const char * image = "test.bin";
+
+static const char * same_file[] = { "test.bin", "/test.bin", "./test.bin",
+	"//test.bin", "./././test.bin" };
+
+static const char * missing[] = { "test.bi", "test.bin2", "test.bin/x",
+	"nothing/test.bin" };
+
+static bool equal(const char* a, const char* b)
+{
+	while (*a && *a == *b) {
+		++a;
+		++b;
+	}
+	return *a == *b;
+}
+
+static uint measure(const char* name, bool exists)
+{
+	const Time start = Time::getCurrent();
+	for (uint i = 0; i < ROUNDS; ++i) {
+		file_t fd;
+		const int res = fopen(&fd, name, OPEN_R);
+		if ((res == EOK) != exists) {
+			panic("fopen(%s) returned %d.\n", name, res);
+		}
+		if (res == EOK)
+			fclose(fd);
+	}
+	return (Time::getCurrent() - start).toUsecs() / ROUNDS;
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	for (uint i = 0; i < sizeof(same_file) / sizeof(same_file[0]); ++i) {
+		file_t fd;
+		if (fopen(&fd, same_file[i], OPEN_R) != EOK) {
+			panic("Failed to open %s.\n", same_file[i]);
+		}
+		fclose(fd);
+	}
+
+	for (uint i = 0; i < sizeof(missing) / sizeof(missing[0]); ++i) {
+		file_t fd;
+		if (fopen(&fd, missing[i], OPEN_R) == EOK) {
+			panic("Opened missing file %s.\n", missing[i]);
+		}
+	}
+
+	/* root directory lists this test */
+	file_t dir;
+	if (fopen(&dir, ".", OPEN_R) != EOK) {
+		panic("Failed to open the root directory.\n");
+	}
+	DIR_ENTRY entry;
+	uint count = 0;
+	bool found = false;
+	while (direntry(dir, &entry) == EOK) {
+		found = found || (equal(entry.name, image) && !entry.is_dir);
+		++count;
+	}
+	fclose(dir);
+	if (!found) {
+		panic("%s is not listed in the root directory.\n", image);
+	}
+
+	const uint hit = measure(image, true);
+	const uint miss = measure(missing[0], false);
+	printf("%u entries, fopen: %u usecs, missing name: %u usecs\n",
+		count, hit, miss);
+
+	printf("Test passed...\n");
+}
@@ -0,0 +1,160 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Per-descriptor positions, pread() and readv() test.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "tools.h"
+
+static const char * desc =
+	"Positional and vectored read test.\n"
+	"Test will open data64k0.dat twice and check that the descriptors have "
+	"independent positions, then compare pread() and readv() results "
+	"with plain fread() of the same data, also from several threads "
+	"sharing one descriptor.\n\n";
+
+//number of threads sharing one descriptor
+#define THREADS 4
+
+//size of one read
+const size_t CHUNK = 1000;
+
+static const char * image = "data64k0.dat";
+
+static char reference[64 * 1024 + 4096];
+
+static size_t size;
+
+static file_t shared_fd;
+
+static bool same(const char* data, const char* expected, size_t len)
+{
+	for (size_t i = 0; i < len; ++i)
+		if (data[i] != expected[i])
+			return false;
+	return true;
+}
+
+static void check(const char* what, const char* data, size_t pos, int res, size_t len)
+{
+	const size_t expected = min(len, size - min(pos, size));
+	if (res < 0 || (size_t)res != expected) {
+		panic("%s at %u returned %d, expected %u.\n", what, pos, res, expected);
+	}
+	if (!same(data, reference + pos, res)) {
+		panic("%s at %u read wrong data.\n", what, pos);
+	}
+}
+
+static void* reader(void* data)
+{
+	const uint id = (uint)data;
+	char buffer[CHUNK];
+
+	/* every thread reads different chunks of the shared descriptor */
+	for (size_t pos = id * CHUNK; pos < size; pos += THREADS * CHUNK) {
+		const int res = pread(shared_fd, buffer, CHUNK, pos);
+		check("pread", buffer, pos, res, CHUNK);
+	}
+	return NULL;
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	file_t fd1, fd2;
+	if (fopen(&fd1, image, OPEN_R) != EOK || fopen(&fd2, image, OPEN_R) != EOK) {
+		panic("Failed to open %s.\n", image);
+	}
+
+	/* reference data */
+	size = fseek(fd1, POS_END, 0);
+	if (size > sizeof(reference)) {
+		panic("%s is too large (%u B).\n", image, size);
+	}
+	fseek(fd1, POS_START, 0);
+	if (fread(fd1, reference, size) != (int)size) {
+		panic("Failed to read %s.\n", image);
+	}
+
+	/* fd1 is at the end, fd2 has to start at the beginning */
+	char buffer[3 * CHUNK];
+	int res = fread(fd2, buffer, CHUNK);
+	check("fread of the second descriptor", buffer, 0, res, CHUNK);
+	if (fread(fd1, buffer, CHUNK) != 0) {
+		panic("First descriptor was moved by the second one.\n");
+	}
+
+	/* pread neither uses nor moves the position */
+	res = pread(fd2, buffer, CHUNK, 5 * CHUNK + 7);
+	check("pread", buffer, 5 * CHUNK + 7, res, CHUNK);
+	res = pread(fd2, buffer, CHUNK, size - 10);
+	check("pread at the end", buffer, size - 10, res, CHUNK);
+	res = fread(fd2, buffer, CHUNK);
+	check("fread after pread", buffer, CHUNK, res, CHUNK);
+
+	/* readv continues from the position, fills buffers in order */
+	char first[100], second[CHUNK], third[7];
+	IOVEC iov[3] = {
+		{ first, sizeof(first) },
+		{ second, sizeof(second) },
+		{ third, sizeof(third) } };
+	res = readv(fd2, iov, 3);
+	const size_t total = sizeof(first) + sizeof(second) + sizeof(third);
+	if (res != (int)total) {
+		panic("readv returned %d, expected %u.\n", res, total);
+	}
+	check("readv first", first, 2 * CHUNK, sizeof(first), sizeof(first));
+	check("readv second", second, 2 * CHUNK + sizeof(first), sizeof(second), sizeof(second));
+	check("readv third", third, 2 * CHUNK + sizeof(first) + sizeof(second),
+		sizeof(third), sizeof(third));
+	res = fread(fd2, buffer, CHUNK);
+	check("fread after readv", buffer, 2 * CHUNK + total, res, CHUNK);
+
+	/* threads sharing a descriptor do not need to seek */
+	shared_fd = fd2;
+	thread_t threads[THREADS];
+	for (uint i = 0; i < THREADS; ++i) {
+		if (thread_create(&threads[i], reader, (void*)i) != EOK) {
+			panic("Failed to create reader %u.\n", i);
+		}
+	}
+	for (uint i = 0; i < THREADS; ++i) {
+		if (thread_join(threads[i], NULL) != EOK) {
+			panic("Failed to join reader %u.\n", i);
+		}
+	}
+
+	fclose(fd1);
+	fclose(fd2);
+
+	printf("Test passed...\n");
+}
@@ -0,0 +1,86 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+/*!
+ * @file
+ * @brief Sampling profiler test.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"Sampling profiler test.\n"
+	"Test will profile a busy loop in user space and a loop of null "
+	"syscalls and print the histogram, spin() and the syscall path "
+	"should be on the top.\n\n";
+
+//sampling interval in microseconds
+const unsigned int INTERVAL = 500;
+
+//length of each loop in microseconds
+const unsigned int RUN = 200000;
+
+static volatile uint counter = 0;
+
+static void __attribute__ ((noinline)) spin()
+{
+	const Time end = Time::getCurrent() + Time(0, RUN);
+	while (Time::getCurrent() < end) {
+		for (uint i = 0; i < 1000; ++i)
+			++counter;
+	}
+}
+
+static void __attribute__ ((noinline)) calls()
+{
+	const Time end = Time::getCurrent() + Time(0, RUN);
+	while (Time::getCurrent() < end) {
+		for (uint i = 0; i < 100; ++i)
+			syscall_nop();
+	}
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	if (profile_start(PROFILE_MIN_INTERVAL - 1) != EINVAL) {
+		panic("Too short interval accepted.\n");
+	}
+	if (profile_start(INTERVAL) != EOK) {
+		panic("Failed to start the profiler.\n");
+	}
+	spin();
+	calls();
+	profile_stop();
+
+	if (profile_dump("test.map") != EOK) {
+		panic("Failed to dump the profile.\n");
+	}
+
+	printf("Test passed...\n");
+}
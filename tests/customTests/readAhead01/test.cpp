@@ -0,0 +1,87 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Read-ahead benchmark.
+ *
+ * Streams a file in small chunks with some work between the reads, the
+ * kernel should notice the sequential access and read the following blocks
+ * while the test is busy.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"Read-ahead benchmark.\n"
+	"Test will read data200k.dat in CHUNK sized pieces, checksumming every "
+	"piece, and report the total time and the time spent waiting in "
+	"fread().\n\n";
+
+//size of one read
+const size_t CHUNK = 4096;
+
+static const char * image = "data200k.dat";
+
+static char buffer[CHUNK];
+
+void
+main (void)
+{
+	printf(desc);
+
+	file_t fd;
+	if (fopen(&fd, image, OPEN_R) != EOK) {
+		panic("Failed to open %s.\n", image);
+	}
+
+	uint waiting = 0, total = 0, sum = 0;
+	const Time start = Time::getCurrent();
+	while (true) {
+		const Time before = Time::getCurrent();
+		const int res = fread(fd, buffer, CHUNK);
+		waiting += (Time::getCurrent() - before).toUsecs();
+		if (res < 0) {
+			panic("Failed to read %s: %d.\n", image, res);
+		}
+		if (res == 0)
+			break;
+		total += res;
+
+		//pretend to process the data
+		for (int i = 0; i < res; ++i)
+			sum = sum * 31 + buffer[i];
+	}
+	const uint elapsed = (Time::getCurrent() - start).toUsecs();
+	fclose(fd);
+
+	printf("results: %s (%u B, checksum %x)\n", image, total, sum);
+	printf("total:   %u usecs\n", elapsed);
+	printf("fread:   %u usecs\n", waiting);
+
+	printf("Test passed...\n");
+}
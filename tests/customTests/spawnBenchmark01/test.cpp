@@ -0,0 +1,103 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Process spawn benchmark.
+ *
+ * Compares the time needed to start a process by reading its image into
+ * a buffer and calling process_create() with the time needed by
+ * process_spawn(), which reads the image straight into the new process.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"Process spawn benchmark.\n"
+	"Test will start every image ROUNDS times using buffered read and "
+	"process_create() and ROUNDS times using process_spawn().\n"
+	"Average time until the call returns is written for both ways.\n\n";
+
+//number of processes started by each method
+const unsigned int ROUNDS = 5;
+
+//images of different size
+static const char * images[] = { "spawn100k.bin", "spawn1m.bin" };
+
+static int create_buffered(process_t* pid, const char* name)
+{
+	file_t fd;
+	if (fopen(&fd, name, OPEN_R) != EOK)
+		return EIO;
+
+	const size_t size = fseek(fd, POS_END, 0);
+	fseek(fd, POS_START, 0);
+
+	void* image = malloc(size);
+	if (!image) {
+		fclose(fd);
+		return ENOMEM;
+	}
+
+	int res = fread(fd, image, size);
+	fclose(fd);
+	if (res >= 0)
+		res = process_create(pid, image, size);
+	free(image);
+	return res;
+}
+
+static uint measure(const char* name, bool spawn)
+{
+	uint total = 0;
+	for (unsigned int i = 0; i < ROUNDS; ++i) {
+		process_t pid;
+		const Time start = Time::getCurrent();
+		const int res = spawn ?
+			process_spawn(&pid, name) : create_buffered(&pid, name);
+		total += (Time::getCurrent() - start).toUsecs();
+		if (res != EOK) {
+			panic("Failed to start %s: %d.\n", name, res);
+		}
+		process_join(pid);
+	}
+	return total / ROUNDS;
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	for (unsigned int i = 0; i < sizeof(images) / sizeof(images[0]); ++i) {
+		printf("results: %s\n", images[i]);
+		printf("buffered: %u usecs\n", measure(images[i], false));
+		printf("spawn:    %u usecs\n", measure(images[i], true));
+	}
+
+	printf("Test passed...\n");
+}
@@ -0,0 +1,94 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Per-thread output buffering test.
+ *
+ * Several threads print lines piece by piece at the same time. Every
+ * thread buffers its own output, so the lines must not be mixed.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"Per-thread stdout buffering test.\n"
+	"THREADS threads print LINES lines each, one word per printf(). "
+	"No line may be mixed with a line of another thread.\n\n";
+
+//number of printing threads
+#define THREADS 4
+
+//number of lines per thread
+#define LINES 50
+
+static void* worker( void* data )
+{
+	const uint id = (uint)data;
+	for (uint i = 0; i < LINES; ++i) {
+		printf("stdoutThreads01:");
+		thread_yield();
+		printf(" thread %u", id);
+		thread_yield();
+		printf(" line %u\n", i);
+	}
+	return NULL;
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	if (stdout_buffering(OUTPUT_FULL) != OUTPUT_LINE) {
+		panic("Line buffering is not the default.\n");
+	}
+	printf("This line is printed by fflush().\n");
+	fflush(STDOUT);
+
+	if (stdout_buffering(42) != EINVAL) {
+		panic("Invalid buffering mode accepted.\n");
+	}
+	stdout_buffering(OUTPUT_LINE);
+
+	thread_t threads[THREADS];
+	const Time start = Time::getCurrent();
+	for (uint i = 0; i < THREADS; ++i) {
+		if (thread_create(&threads[i], worker, (void*)i) != EOK) {
+			panic("Failed to create thread %u.\n", i);
+		}
+	}
+	for (uint i = 0; i < THREADS; ++i) {
+		if (thread_join(threads[i], NULL) != EOK) {
+			panic("Failed to join thread %u.\n", i);
+		}
+	}
+	const uint usecs = (Time::getCurrent() - start).toUsecs();
+
+	printf("printf: %u usecs per line\n", usecs / (THREADS * LINES));
+	printf("Test passed...\n");
+}
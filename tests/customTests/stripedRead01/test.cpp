@@ -0,0 +1,111 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Striped volume test.
+ *
+ * Meant to be run with several disks (make DISKS=n, msim-raid<n>.conf),
+ * works on a single disk as well. One large read is spread over all disks
+ * at once, small reads go through the cache one stripe at a time, both
+ * have to return the same data.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"Striped volume test.\n"
+	"Test will read data400k.dat by one large fread() and by fread() "
+	"of SMALL bytes, compare checksums and report throughput.\n\n";
+
+//size of the small reads
+const size_t SMALL = 3000;
+
+static const char * image = "data400k.dat";
+
+static uint checksum(const char* data, size_t size)
+{
+	uint sum = 0;
+	for (size_t i = 0; i < size; ++i)
+		sum = sum * 31 + data[i];
+	return sum;
+}
+
+static void report(const char* name, size_t size, uint usecs)
+{
+	if (!usecs) usecs = 1;
+	/* bytes per usec is MB/s, keep two decimals */
+	const uint rate = (uint)((unsigned long long)size * 100 / usecs);
+	printf("%s %u.%02u MB/s (%u B in %u usecs)\n",
+		name, rate / 100, rate % 100, size, usecs);
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	file_t fd;
+	if (fopen(&fd, image, OPEN_R) != EOK) {
+		panic("Failed to open %s.\n", image);
+	}
+
+	const size_t size = fseek(fd, POS_END, 0);
+	char* buffer = (char*)malloc(size);
+	if (!buffer) {
+		panic("Not enough memory for %u bytes.\n", size);
+	}
+
+	fseek(fd, POS_START, 0);
+	Time start = Time::getCurrent();
+	if (fread(fd, buffer, size) != (int)size) {
+		panic("Failed to read %s.\n", image);
+	}
+	report("large:", size, (Time::getCurrent() - start).toUsecs());
+	const uint expected = checksum(buffer, size);
+
+	fseek(fd, POS_START, 0);
+	start = Time::getCurrent();
+	for (size_t pos = 0; pos < size; ) {
+		const int res = fread(fd, buffer + pos, SMALL);
+		if (res <= 0) {
+			panic("Failed to read %s: %d.\n", image, res);
+		}
+		pos += res;
+	}
+	report("small:", size, (Time::getCurrent() - start).toUsecs());
+
+	const uint sum = checksum(buffer, size);
+	if (sum != expected) {
+		panic("Checksum differs: %x, expected %x.\n", sum, expected);
+	}
+
+	free(buffer);
+	fclose(fd);
+
+	printf("Test passed...\n");
+}
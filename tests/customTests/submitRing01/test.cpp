@@ -0,0 +1,143 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Batched syscall test.
+ *
+ * Fills the submission ring, checks that every syscall gets its result
+ * in order and compares the time of batched and separate null syscalls.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"Batched syscall test.\n"
+	"Test will fill the submission ring, run it with one syscall and "
+	"check the results. Then it will run CALLS null syscalls one by one "
+	"and in batches and write average time of 1000 calls.\n\n";
+
+//number of null syscalls in the benchmark
+const unsigned int CALLS = 16000;
+
+//syscall code nobody handles
+const unsigned int BAD_CODE = 1000;
+
+static void check_ring()
+{
+	/* fill the ring, the last entry is not a syscall */
+	for (uint i = 0; i < SUBMIT_RING_SIZE - 1; ++i) {
+		if (submit_add(SYS_NOP, 0, 0, 0, 0, i) != EOK) {
+			panic("Failed to queue syscall %u.\n", i);
+		}
+	}
+	if (submit_add(BAD_CODE, 0, 0, 0, 0, SUBMIT_RING_SIZE - 1) != EOK) {
+		panic("Failed to queue the last syscall.\n");
+	}
+	if (submit_add(SYS_NOP, 0, 0, 0, 0, 0) != EWOULDBLOCK) {
+		panic("Full ring accepted a syscall.\n");
+	}
+	if (submit_add(SYS_SUBMIT, 0, 0, 0, 0, 0) != EINVAL) {
+		panic("Nested submit accepted.\n");
+	}
+	if (submit_add(SYS_EXIT, 0, 0, 0, 0, 0) != EINVAL
+	    || submit_add(SYS_THREAD_EXIT, 0, 0, 0, 0, 0) != EINVAL) {
+		panic("Exit accepted to the ring.\n");
+	}
+
+	unative_t tag, result;
+	if (submit_reap(&tag, &result) != EWOULDBLOCK) {
+		panic("Result available before submit.\n");
+	}
+
+	PROCESS_STAT before, after;
+	process_stat(process_self(), &before);
+	const int count = submit();
+	process_stat(process_self(), &after);
+	if (count != SUBMIT_RING_SIZE) {
+		panic("Submit ran %d syscalls instead of %u.\n", count, SUBMIT_RING_SIZE);
+	}
+	/* every batched syscall counts, so do submit() and process_stat() */
+	if (after.syscalls != before.syscalls + SUBMIT_RING_SIZE + 2) {
+		panic("%u syscalls counted instead of %u.\n",
+			after.syscalls - before.syscalls, SUBMIT_RING_SIZE + 2);
+	}
+
+	for (uint i = 0; i < SUBMIT_RING_SIZE; ++i) {
+		if (submit_reap(&tag, &result) != EOK) {
+			panic("Missing result %u.\n", i);
+		}
+		const unative_t expected = (unative_t)((i == SUBMIT_RING_SIZE - 1) ? EINVAL : EOK);
+		if (tag != i || result != expected) {
+			panic("Wrong result %u: tag %u, result %d.\n", i, tag, result);
+		}
+	}
+	if (submit_reap(&tag, &result) != EWOULDBLOCK) {
+		panic("Too many results.\n");
+	}
+}
+
+static uint separate()
+{
+	const Time start = Time::getCurrent();
+	for (uint i = 0; i < CALLS; ++i) {
+		syscall_nop();
+	}
+	return (Time::getCurrent() - start).toUsecs();
+}
+
+static uint batched()
+{
+	const Time start = Time::getCurrent();
+	for (uint i = 0; i < CALLS; i += SUBMIT_RING_SIZE) {
+		for (uint j = 0; j < SUBMIT_RING_SIZE; ++j) {
+			submit_add(SYS_NOP, 0, 0, 0, 0, j);
+		}
+		submit();
+		for (uint j = 0; j < SUBMIT_RING_SIZE; ++j) {
+			if (submit_reap(NULL, NULL) != EOK) {
+				panic("Missing result in batch %u.\n", i / SUBMIT_RING_SIZE);
+			}
+		}
+	}
+	return (Time::getCurrent() - start).toUsecs();
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	check_ring();
+
+	printf("results: \nseparate: %u usecs per 1000 calls\n",
+		separate() / (CALLS / 1000));
+	printf("results: \nbatched:  %u usecs per 1000 calls\n",
+		batched() / (CALLS / 1000));
+
+	printf("Test passed...\n");
+}
@@ -0,0 +1,99 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Syscall latency benchmark.
+ *
+ * Measures the round trip to the kernel with a syscall that does nothing
+ * and compares it to reading the clock, which needs no syscall. Checks
+ * that the clock moves while the thread sleeps.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"Syscall latency benchmark.\n"
+	"Test will call the null syscall and read the clock CALLS times "
+	"each and write average time of 1000 calls.\n\n";
+
+//time to sleep when checking the clock
+const unsigned int SLEEP_USECS = 50000;
+
+//number of calls of each syscall
+const unsigned int CALLS = 20000;
+
+static uint nullCalls()
+{
+	const Time start = Time::getCurrent();
+	for (uint i = 0; i < CALLS; ++i) {
+		if (syscall_nop() != EOK) {
+			panic("Null syscall failed.\n");
+		}
+	}
+	return (Time::getCurrent() - start).toUsecs();
+}
+
+static uint timeCalls()
+{
+	const Time start = Time::getCurrent();
+	Time last = Time::getCoarseTime();
+	for (uint i = 0; i < CALLS; ++i) {
+		const Time now = Time::getCoarseTime();
+		if (now < last) {
+			panic("Time went backwards.\n");
+		}
+		last = now;
+	}
+	return (Time::getCurrent() - start).toUsecs();
+}
+
+static void checkSleep()
+{
+	const Time start = Time::getCoarseTime();
+	thread_usleep(SLEEP_USECS);
+	const uint slept = (Time::getCoarseTime() - start).toUsecs();
+	if (slept < SLEEP_USECS) {
+		panic("Clock moved only %u usecs during %u usecs sleep.\n",
+			slept, SLEEP_USECS);
+	}
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	checkSleep();
+
+	printf("results: \nnull syscall: %u usecs per 1000 calls\n",
+		nullCalls() / (CALLS / 1000));
+	printf("results: \nclock read:   %u usecs per 1000 calls\n",
+		timeCalls() / (CALLS / 1000));
+
+	printf("Test passed...\n");
+}
@@ -0,0 +1,101 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file
+ * @brief Thread creation benchmark.
+ *
+ * Measures how long it takes to create and join a thread, both for threads
+ * created one by one and for batches of threads running at the same time.
+ * Kernel stacks of the finished threads are recycled so repeated rounds
+ * should not get slower than the first one.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+#include "Time.h"
+
+static const char * desc =
+	"Thread creation benchmark.\n"
+	"Test will create and join ROUNDS threads one after another and then "
+	"create BATCH threads at once and join them, BATCH_ROUNDS times.\n"
+	"Average time needed for one create/join pair is written in both cases.\n\n";
+
+//number of sequential create/join pairs
+const unsigned int ROUNDS = 200;
+//number of threads running at once in the batch phase
+const unsigned int BATCH = 16;
+//number of batches
+const unsigned int BATCH_ROUNDS = 20;
+
+static void* worker(void* data)
+{
+	return data;
+}
+
+static uint sequential()
+{
+	const Time start = Time::getCurrent();
+	for (unsigned int i = 0; i < ROUNDS; ++i) {
+		thread_t thread;
+		if (thread_create(&thread, worker, NULL) != EOK) {
+			panic("Failed to create thread %u.\n", i);
+		}
+		if (thread_join(thread, NULL) != EOK) {
+			panic("Failed to join thread %u.\n", i);
+		}
+	}
+	return (Time::getCurrent() - start).toUsecs() / ROUNDS;
+}
+
+static uint batched()
+{
+	thread_t threads[BATCH];
+	const Time start = Time::getCurrent();
+	for (unsigned int round = 0; round < BATCH_ROUNDS; ++round) {
+		for (unsigned int i = 0; i < BATCH; ++i) {
+			if (thread_create(&threads[i], worker, NULL) != EOK) {
+				panic("Failed to create thread %u in batch %u.\n", i, round);
+			}
+		}
+		for (unsigned int i = 0; i < BATCH; ++i) {
+			if (thread_join(threads[i], NULL) != EOK) {
+				panic("Failed to join thread %u in batch %u.\n", i, round);
+			}
+		}
+	}
+	return (Time::getCurrent() - start).toUsecs() / (BATCH * BATCH_ROUNDS);
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	printf("results: \nsequential: %u usecs per thread\n", sequential());
+	printf("results: \nbatched:    %u usecs per thread\n", batched());
+
+	printf("Test passed...\n");
+}
@@ -0,0 +1,127 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+/*!
+ * @file
+ * @brief Tracepoint test.
+ */
+
+#include "librt.h"
+#include "../include/defs.h"
+
+static const char * desc =
+	"Tracepoint test.\n"
+	"Test will trace CALLS null syscalls and check the records, then it "
+	"will overflow the kernel ring and check that the lost records are "
+	"reported.\n\n";
+
+//number of traced null syscalls
+const unsigned int CALLS = 10;
+
+//null syscalls overflowing the ring, two records each
+const unsigned int FLOOD = 3000;
+
+//size of the kernel ring
+const unsigned int RING = 4096;
+
+static TRACE_RECORD records[RING + 1];
+
+static int read_all()
+{
+	return trace_read(records, sizeof(records) / sizeof(TRACE_RECORD));
+}
+
+static void check(uint i, uint event, uint arg0)
+{
+	if (records[i].event != event || records[i].arg0 != arg0) {
+		panic("Record %u is event %u(%u), expected %u(%u).\n",
+			i, records[i].event, records[i].arg0, event, arg0);
+	}
+}
+
+static void check_calls()
+{
+	trace_enable(TRACE_SYSCALL);
+	for (uint i = 0; i < CALLS; ++i) {
+		syscall_nop();
+	}
+	trace_enable(0);
+
+	/* the enabling syscall is traced from its exit,
+	 * the disabling one up to its entry */
+	const int count = read_all();
+	if (count != (int)(2 * CALLS + 3)) {
+		panic("Read %d records, expected %u.\n", count, 2 * CALLS + 3);
+	}
+	check(0, TRACE_START, records[0].arg0);
+	if (records[0].arg0 == 0 || records[0].arg1 != TRACE_SYSCALL) {
+		panic("Wrong start record: %u cycles per usec, mask %x.\n",
+			records[0].arg0, records[0].arg1);
+	}
+	check(1, TRACE_SYSCALL_EXIT, SYS_TRACE);
+	for (uint i = 0; i < CALLS; ++i) {
+		check(2 + 2 * i, TRACE_SYSCALL_ENTER, SYS_NOP);
+		check(3 + 2 * i, TRACE_SYSCALL_EXIT, SYS_NOP);
+		if (records[3 + 2 * i].thread != thread_self()) {
+			panic("Record of another thread %u.\n", records[3 + 2 * i].thread);
+		}
+	}
+	check(2 * CALLS + 2, TRACE_SYSCALL_ENTER, SYS_TRACE);
+
+	if (read_all() != 0) {
+		panic("Records taken after tracing stopped.\n");
+	}
+}
+
+static void check_overflow()
+{
+	trace_enable(TRACE_SYSCALL);
+	for (uint i = 0; i < FLOOD; ++i) {
+		syscall_nop();
+	}
+	trace_enable(0);
+
+	const uint written = 2 * FLOOD + 3;
+	const int count = read_all();
+	if (count != (int)RING + 1) {
+		panic("Read %d records, expected %u.\n", count, RING + 1);
+	}
+	check(0, TRACE_LOST, written - RING);
+	check(count - 1, TRACE_SYSCALL_ENTER, SYS_TRACE);
+}
+
+void
+main (void)
+{
+	printf(desc);
+
+	/* forget anything traced before */
+	trace_enable(0);
+	read_all();
+
+	check_calls();
+	check_overflow();
+
+	printf("Test passed...\n");
+}
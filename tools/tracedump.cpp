@@ -0,0 +1,153 @@
+/*
+ *          _     _
+ *          \`\ /`/
+ *           \ V /
+ *           /. .\            Bunny Kernel for MIPS
+ *          =\ T /=
+ *           / ^ \
+ *        {}/\\ //\
+ *        __\ " " /__
+ *   jgs (____/^\____)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/*! 	 
+ *   @author Matus Dekanek, Tomas Petrusek, Lubos Slovak, Jan Vesely
+ *   @par "SVN Repository"
+ *   svn://aiya.ms.mff.cuni.cz/osy0809-depeslve
+ *   
+ *   @version $Id$
+ *   @note
+ *   Semestral work for Operating Systems course at MFF UK \n
+ *   http://dsrg.mff.cuni.cz/~ceres/sch/osy/main.php
+ *
+ *   @date 2008-2009
+ */
+
+/*!
+ * @file 
+ * @brief Host tool decoding trace dumps into a timeline.
+ *
+ * The init shell command 'trace <mask> <file>' appends dumps to
+ * results.log on the disk, get it by 'tar -xf disk.tar results.log' and run
+ * 'tools/tracedump results.log'. Every dump found in the file is printed,
+ * other contents of the log are skipped.
+ *
+ * Built by 'make tools' with the host compiler.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "../shared/trace.h"
+
+/*! @brief Description of one tracepoint. */
+struct EventInfo {
+	const char* name;   /*!< Event name.                        */
+	const char* arg0;   /*!< Name of the first argument.        */
+	const char* arg1;   /*!< Name of the second argument.       */
+};
+
+#define TRACE_EVENT_INFO( id, category, name, arg0, arg1 ) { name, arg0, arg1 },
+
+static const EventInfo EVENTS[] = {
+	TRACE_EVENTS( TRACE_EVENT_INFO )
+};
+
+/*!
+ * @brief Prints one argument, addresses in hexadecimal.
+ * @param name Name of the argument, empty if unused.
+ * @param value The value.
+ */
+static void print_arg( const char* name, unsigned int value )
+{
+	if (!*name)
+		return;
+	const bool hex = !strcmp( name, "address" ) || !strcmp( name, "epc" )
+		|| !strcmp( name, "cause" ) || !strcmp( name, "mask" );
+	printf( hex ? " %s=0x%08x" : " %s=%u", name, value );
+}
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Prints records of one dump as a timeline.
+ * @param records The records.
+ * @param count Number of records.
+ */
+static void print_timeline( const TRACE_RECORD* records, unsigned int count )
+{
+	unsigned int cycles_per_usec = 0;
+	unsigned long long elapsed = 0;
+
+	printf( "%12s %10s %6s  %-14s %s\n", "TIME(us)", "DELTA", "THREAD", "EVENT", "ARGS" );
+	for (unsigned int i = 0; i < count; ++i) {
+		const TRACE_RECORD& record = records[i];
+		/* Count wraps, records are much closer than one wrap */
+		const unsigned int delta = i ? record.cycles - records[i - 1].cycles : 0;
+		elapsed += delta;
+
+		if (record.event == TRACE_START)
+			cycles_per_usec = record.arg0;
+		const unsigned int scale = cycles_per_usec ? cycles_per_usec : 1;
+
+		printf( "%12llu %10u %6u  ", elapsed / scale, delta / scale, record.thread );
+		if (record.event >= TRACE_EVENT_COUNT) {
+			printf( "%-14s 0x%08x 0x%08x\n", "unknown", record.arg0, record.arg1 );
+			continue;
+		}
+		const EventInfo& info = EVENTS[record.event];
+		printf( "%-14s", info.name );
+		print_arg( info.arg0, record.arg0 );
+		print_arg( info.arg1, record.arg1 );
+		printf( "\n" );
+	}
+	if (!cycles_per_usec)
+		printf( "No start record, times are in cycles.\n" );
+}
+/*----------------------------------------------------------------------------*/
+int main( int argc, char* argv[] )
+{
+	if (argc != 2) {
+		fprintf( stderr, "Usage: %s <results.log>\n", argv[0] );
+		return 1;
+	}
+
+	FILE* file = fopen( argv[1], "rb" );
+	if (!file) {
+		perror( argv[1] );
+		return 1;
+	}
+	std::vector<char> data;
+	char buffer[4096];
+	size_t read;
+	while ((read = fread( buffer, 1, sizeof(buffer), file )) > 0)
+		data.insert( data.end(), buffer, buffer + read );
+	fclose( file );
+
+	const size_t magic = sizeof(TRACE_DUMP_MAGIC) - 1;
+	unsigned int dumps = 0;
+	for (size_t pos = 0; pos + magic + sizeof(unsigned int) <= data.size(); ++pos) {
+		if (memcmp( &data[pos], TRACE_DUMP_MAGIC, magic ))
+			continue;
+
+		unsigned int count;
+		memcpy( &count, &data[pos + magic], sizeof(count) );
+		const size_t start = pos + magic + sizeof(count);
+		if (start + (size_t)count * sizeof(TRACE_RECORD) > data.size()) {
+			fprintf( stderr, "Dump at %zu is truncated.\n", pos );
+			count = (data.size() - start) / sizeof(TRACE_RECORD);
+		}
+
+		std::vector<TRACE_RECORD> records( count );
+		if (count)
+			memcpy( &records[0], &data[start], count * sizeof(TRACE_RECORD) );
+		printf( "Dump %u: %u records\n", ++dumps, count );
+		print_timeline( count ? &records[0] : NULL, count );
+		pos = start + (size_t)count * sizeof(TRACE_RECORD) - 1;
+	}
+
+	if (!dumps) {
+		fprintf( stderr, "No trace dump found in %s.\n", argv[1] );
+		return 1;
+	}
+	return 0;
+}